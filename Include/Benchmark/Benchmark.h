@@ -0,0 +1,76 @@
+#ifndef BENCHMARK_BENCHMARK_H
+#define BENCHMARK_BENCHMARK_H
+
+#include <string>
+#include <vector>
+#include <chrono>
+#include <functional>
+
+/* keeps the compiler from optimizing away a result that is not used
+*/
+template <typename T>
+inline void benchKeep(const T& value){
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+/* handed to a benchmark function, the function runs its operation
+ * getIterations() times. Work that should not be timed (building a
+ * fixture) goes between pause() and resume()
+*/
+class BenchStateClass{
+    private:
+        long iterations;
+        /* items processed per operation, for the items/sec column
+        */
+        double itemsPerOp;
+        std::chrono::steady_clock::time_point start;
+        double elapsed;
+        bool running;
+
+    public:
+        BenchStateClass(long _iterations);
+
+        long getIterations(void);
+        void setItemsPerOp(double items);
+        double getItemsPerOp(void);
+        void pause(void);
+        void resume(void);
+        /* timed seconds, only valid once the state is paused
+        */
+        double getElapsed(void);
+};
+
+typedef struct{
+    std::string name;
+    std::function<void(BenchStateClass&)> fn;
+}benchmark_t;
+
+typedef struct{
+    std::string name;
+    long iterations;
+    double nsPerOp;
+    double itemsPerSec;
+}benchResult_t;
+
+/* Self contained runner in the spirit of Google Benchmark. A benchmark
+ * is first run with one iteration, the count is then grown until a run
+ * takes at least minTime seconds and that run is reported
+*/
+class BenchmarkClass{
+    private:
+        std::vector<benchmark_t> benchmarks;
+        double minTime;
+
+        benchResult_t runOne(benchmark_t& benchmark);
+
+    public:
+        BenchmarkClass(double _minTime = 0.5);
+
+        void add(const std::string& name, std::function<void(BenchStateClass&)> fn);
+        /* runs the benchmarks whose name contains filter and prints a
+         * line per benchmark as soon as it is done
+        */
+        std::vector<benchResult_t> run(const std::string& filter = "");
+};
+#endif /* BENCHMARK_BENCHMARK_H
+*/
@@ -0,0 +1,68 @@
+#ifndef BENCHMARK_PLANNERBENCH_H
+#define BENCHMARK_PLANNERBENCH_H
+
+#include "../../Include/Benchmark/Benchmark.h"
+#include "../../Include/Simulation/RandomTree.h"
+#include <vector>
+#include <map>
+
+/* headless planner without a goal whose kernels can be called by the
+ * benchmarks
+*/
+class KernelPlannerClass: public RandomTreeClass{
+    public:
+        KernelPlannerClass(int N, std::vector<int>& cells, plannerType planner);
+
+        using RandomTreeClass::getNearestNode;
+        using RandomTreeClass::connectTwoCells;
+        using RandomTreeClass::isNodeValid;
+        using RandomTreeClass::getRandomAmount;
+        using RandomTreeClass::setCellBlockToState;
+        using TreeClass::getNodeFromCell;
+        /* the cell states are written to a grid of the planner's own
+         * from now on, a headless planner only reads the shared grid.
+         * Returns the new grid
+        */
+        const int* useOwnGrid(void);
+};
+
+/* benchmarks of the planner kernels, run on headless planners with
+ * fixed seeds so that every run does the same work
+*/
+class PlannerBenchClass{
+    private:
+        /* grid sizes, the nearest node trees go up to 1M nodes and need
+         * the bigger grid
+        */
+        static const int largeN = 2048;
+        static const int planN = 800;
+        /* the trees of the iteration benchmarks are started over after
+         * this many iterations
+        */
+        static const int treeIterations = 2000;
+
+        std::vector<int> largeCells;
+        std::vector<int> planCells;
+        /* trees of the nearest node benchmarks by node count, built on
+         * first use
+        */
+        std::map<int, KernelPlannerClass*> nearestTrees;
+
+        KernelPlannerClass* getNearestTree(int numNodes);
+
+        void benchNearestNode(BenchStateClass& state, int numNodes);
+        void benchConnectTwoCells(BenchStateClass& state, int length);
+        void benchNodeValid(BenchStateClass& state, int length);
+        void benchDistanceToRoot(BenchStateClass& state, int depth);
+        void benchRandomAmount(BenchStateClass& state);
+        void benchCellBlockToState(BenchStateClass& state, int width);
+        void benchIteration(BenchStateClass& state, plannerType planner);
+
+    public:
+        PlannerBenchClass(void);
+        ~PlannerBenchClass(void);
+
+        void addBenchmarks(BenchmarkClass& bench);
+};
+#endif /* BENCHMARK_PLANNERBENCH_H
+*/
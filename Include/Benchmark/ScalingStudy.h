@@ -0,0 +1,75 @@
+#ifndef BENCHMARK_SCALINGSTUDY_H
+#define BENCHMARK_SCALINGSTUDY_H
+
+#include "../../Include/Simulation/RandomTree.h"
+#include <string>
+#include <vector>
+
+/* one point of a scaling series, the cost of an iteration at a tree
+ * size, grid size or thread count
+*/
+typedef struct{
+    std::string study;
+    std::string planner;
+    /* node count, N or number of threads
+    */
+    long size;
+    long nodes;
+    long iterations;
+    double seconds;
+    /* per iteration latency percentiles in microseconds
+    */
+    double p50, p99;
+    /* grid and tree memory
+    */
+    size_t memory;
+    /* the per iteration cost grows like size^exponent since the point
+     * before, 0 for the first point of a series
+    */
+    double exponent;
+    bool superLinear;
+    bool skipped;
+}scalingPoint_t;
+
+/* Records how the cost of a planner iteration changes
+ *   - as one tree grows from 1k to 1M nodes (RRT and RRT*)
+ *   - as the grid grows from N = 800 to 32000
+ *   - as 1 to 64 threads plan at once, each with its own planner over
+ *     one shared grid like the query pool workers
+ * A point whose per iteration cost grows faster than size^0.25 since
+ * the point before is flagged as super-linear, the total work then
+ * grows faster than linear in the size. The trees grow without a goal
+*/
+class ScalingStudyClass{
+    private:
+        /* grid of the node and thread series
+        */
+        static const int treeN = 2048;
+        /* iterations per point of the grid series and per thread of
+         * the thread series, so every tree grows to the same size
+        */
+        static const int pointIterations = 2000;
+        static constexpr double maxExponent = 0.25;
+
+        /* a series stops once it has taken this many seconds
+        */
+        double budget;
+        std::vector<scalingPoint_t> points;
+
+        void iterate(RandomTreeClass& p, std::vector<double>& latencies);
+        void addPoint(scalingPoint_t point, std::vector<double>& latencies);
+
+        void studyNodes(plannerType planner);
+        void studyGrid(void);
+        void studyThreads(void);
+
+    public:
+        ScalingStudyClass(double _budget);
+
+        void run(void);
+        /* one line per point
+        */
+        bool writeCSV(const std::string& fileName);
+};
+#endif /* BENCHMARK_SCALINGSTUDY_H
+*/
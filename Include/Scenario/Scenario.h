@@ -0,0 +1,67 @@
+#ifndef SCENARIO_SCENARIO_H
+#define SCENARIO_SCENARIO_H
+
+#include "../../Include/Simulation/Portfolio.h"
+#include <string>
+#include <vector>
+
+/* version of the corpus, bump it whenever a generator or the list of
+ * scenarios changes so that results of different corpora are never
+ * compared
+*/
+const int corpusVersion = 1;
+
+typedef enum{
+    SCENARIO_OPEN,
+    SCENARIO_CLUTTER,
+    SCENARIO_MAZE,
+    SCENARIO_NARROW,
+    SCENARIO_BUGTRAP,
+    NUM_SCENARIO_TYPES
+}scenarioType;
+
+/* start and goal cells, (i,j) like the planner, and the length of the
+ * shortest 8-connected grid path between them
+*/
+typedef struct{
+    std::pair<int, int> start;
+    std::pair<int, int> goal;
+    float gridOptimal;
+}scenarioQuery_t;
+
+typedef struct{
+    std::string name;
+    scenarioType type;
+    int N;
+    unsigned int seed;
+    /* cell (i,j) is at i + j*N, FREE or OBSTACLE
+    */
+    std::vector<int> cells;
+    std::vector<scenarioQuery_t> queries;
+    /* set if the map has a tuned planner configuration, tuned for
+     * tunedLatency seconds per query
+    */
+    bool tuned;
+    plannerConfig_t tunedConfig;
+    double tunedLatency;
+}scenario_t;
+
+const char* getScenarioTypeName(scenarioType type);
+/* the same type, N and seed always give the same map and queries, on
+ * any platform
+*/
+scenario_t generateScenario(scenarioType type, int N, unsigned int seed);
+/* every type at every corpus grid size and seed
+*/
+std::vector<scenario_t> generateCorpus(void);
+
+/* A corpus directory holds corpus.txt (version and scenario list) and
+ * per scenario a <name>.map and <name>.scen file in the Moving AI
+ * benchmark format, x is i and y is j. A tuned map also has a
+ * <name>.tune file, which is loaded with the map
+*/
+bool writeCorpus(const std::string& dir, const std::vector<scenario_t>& corpus);
+bool readCorpus(const std::string& dir, std::vector<scenario_t>& corpus);
+bool writeTunedConfig(const std::string& dir, const scenario_t& scenario);
+#endif /* SCENARIO_SCENARIO_H
+*/
@@ -0,0 +1,82 @@
+#ifndef SCENARIO_SCENARIORUNNER_H
+#define SCENARIO_SCENARIORUNNER_H
+
+#include "../../Include/Scenario/Scenario.h"
+#include "../../Include/Simulation/Portfolio.h"
+#include "../../Include/Utils/Arena.h"
+#include <string>
+#include <vector>
+
+/* the outcome of planning one query
+*/
+typedef struct{
+    bool pathFound;
+    /* seconds until solve() returned, which is the time to the first
+     * solution if one was found
+    */
+    double time;
+    float cost;
+    /* cost over the shortest 8-connected grid path, an any angle path
+     * can be a little below 1
+    */
+    float costRatio;
+    /* tree memory (nodes and map entries) at the end of the run
+    */
+    size_t memory;
+}queryResult_t;
+
+/* one planner run on one query of a scenario
+*/
+typedef struct{
+    int scenarioIdx;
+    int queryIdx;
+    int configIdx;
+    int repeat;
+    queryResult_t result;
+}scenarioRun_t;
+
+/* Runs every planner configuration on every query of a corpus, repeats
+ * times with different planner seeds. A tuned map is also run with its
+ * tuned configuration. The runs are done one after the other so they do
+ * not disturb each other's timing
+*/
+class ScenarioRunnerClass{
+    private:
+        const std::vector<scenario_t>& corpus;
+        std::vector<plannerConfig_t> configs;
+        int maxIterations;
+        int repeats;
+        std::vector<scenarioRun_t> runs;
+
+        int getNumConfigs(const scenario_t& scenario);
+        const plannerConfig_t& getConfig(const scenario_t& scenario, int configIdx);
+        std::string getRunConfigName(const scenario_t& scenario, int configIdx);
+
+    public:
+        ScenarioRunnerClass(const std::vector<scenario_t>& _corpus,
+        std::vector<plannerConfig_t> _configs, int _maxIterations, int _repeats);
+
+        /* only the scenarios whose name contains filter are run
+        */
+        void run(const std::string& filter = "");
+        /* success rate, time to first solution percentiles, cost and
+         * memory per configuration, scenario type and grid size
+        */
+        void printSummary(void);
+        /* one line per run
+        */
+        bool writeCSV(const std::string& fileName);
+};
+
+/* plans query on the map of scenario with config, the tree is built on
+ * arena which is reset afterwards, the path is left in path
+*/
+queryResult_t runQuery(const scenario_t& scenario, const scenarioQuery_t& query,
+const plannerConfig_t& config, int maxIterations, ArenaClass& arena,
+std::vector<std::pair<int, int>>& path);
+std::string getConfigName(const plannerConfig_t& config);
+/* planner configurations compared by default
+*/
+std::vector<plannerConfig_t> getDefaultConfigs(void);
+#endif /* SCENARIO_SCENARIORUNNER_H
+*/
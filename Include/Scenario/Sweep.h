@@ -0,0 +1,69 @@
+#ifndef SCENARIO_SWEEP_H
+#define SCENARIO_SWEEP_H
+
+#include "../../Include/Scenario/ScenarioRunner.h"
+#include "../../Include/Simulation/Portfolio.h"
+#include <string>
+#include <vector>
+#include <atomic>
+
+/* the parameter space of a sweep, every combination of the values is
+ * run on every query of numMaps generated maps per type and size, with
+ * numSeeds planner seeds each
+*/
+typedef struct{
+    std::vector<scenarioType> types;
+    std::vector<int> sizes;
+    std::vector<int> steps;
+    std::vector<int> neighborhoods;
+    std::vector<plannerType> planners;
+    std::vector<samplerType> samplers;
+    int numMaps;
+    int numSeeds;
+    int maxIterations;
+    int numThreads;
+}sweepSpec_t;
+
+typedef struct{
+    int scenarioIdx;
+    int queryIdx;
+    plannerConfig_t config;
+    queryResult_t result;
+}sweepRun_t;
+
+/* Runs a parameter sweep on all cores, the runs are independent and are
+ * handed out to the worker threads one at a time. The workers compete
+ * for caches and memory bandwidth so the times are comparable within a
+ * sweep, use threads=1 to compare them with the scenario runner
+*/
+class SweepClass{
+    private:
+        sweepSpec_t spec;
+        std::vector<scenario_t> scenarios;
+        std::vector<sweepRun_t> runs;
+        std::atomic<int> nextRun;
+
+        void worker(void);
+
+    public:
+        SweepClass(const sweepSpec_t& _spec);
+
+        void run(void);
+        /* one line per run
+        */
+        bool writeCSV(const std::string& fileName);
+};
+
+/* every map type, N = 200, a few step and neighborhood values, both
+ * planners and samplers, 3 seeds and all cores
+*/
+sweepSpec_t getDefaultSweepSpec(void);
+/* key=value, the values are a comma separated list or an inclusive
+ * start:end:increment range for the numeric keys
+ *   type=open,maze  N=200,400  step=5:40:5  nbhd=25:200:25
+ *   planner=rrt,rrt*  sampler=uniform,goal  maps=1  seeds=3
+ *   maxIter=5000  threads=8
+*/
+bool parseSweepArg(const std::string& arg, sweepSpec_t& spec);
+#endif /* SCENARIO_SWEEP_H
+*/
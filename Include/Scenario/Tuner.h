@@ -0,0 +1,48 @@
+#ifndef SCENARIO_TUNER_H
+#define SCENARIO_TUNER_H
+
+#include "../../Include/Scenario/Scenario.h"
+#include "../../Include/Simulation/Portfolio.h"
+#include <vector>
+
+/* a step/neighborhood candidate and its trials so far, a trial
+ * succeeds if a path is found within the latency target
+*/
+typedef struct{
+    plannerConfig_t config;
+    int numTrials;
+    int numSolved;
+    double costRatioSum;
+}tunerCandidate_t;
+
+/* Tunes step and neighborhood of a planner for one map with successive
+ * halving. Every candidate gets a few short trials (a query and a seed
+ * each), the better half is kept and gets twice the trials, until one
+ * candidate is left. Candidates are ranked by the share of trials solved
+ * within the latency target and then by the mean cost ratio
+*/
+class TunerClass{
+    private:
+        const scenario_t& scenario;
+        plannerType planner;
+        samplerType sampler;
+        /* seconds
+        */
+        double latencyTarget;
+        int initialTrials;
+        std::vector<tunerCandidate_t> candidates;
+
+        void initCandidates(void);
+        void runTrials(tunerCandidate_t& candidate, int numTrials);
+        static bool isBetter(const tunerCandidate_t& a, const tunerCandidate_t& b);
+
+    public:
+        /* initialTrials defaults to one trial per query of the map
+        */
+        TunerClass(const scenario_t& _scenario, plannerType _planner, samplerType _sampler,
+        double _latencyTarget, int _initialTrials = 0);
+
+        plannerConfig_t tune(void);
+};
+#endif /* SCENARIO_TUNER_H
+*/
@@ -4,6 +4,30 @@
 /* step through render loop
 */
 #define STEP_MODE                   0
+/* run the simulation on its own thread instead of once per 
+ * rendered frame
+*/
+#define SIMULATION_THREAD           1
+/* when the simulation runs on the render thread, time (ms) spent
+ * on simulation steps per frame. 0 runs one step per frame
+*/
+const double frameBudget = 12.0;
+/* record the window from the first frame on, as numbered PPM files
+ * (CAPTURE_PPM) or one raw RGB file (CAPTURE_RAW) named after 
+ * captureFilePrefix. The C key starts and stops recording at any time
+*/
+#define CAPTURE_MODE                0
+#define CAPTURE_FORMAT              CAPTURE_PPM
+const char captureFilePrefix[] = "capture";
+/* phase times and counters of the run are written here on exit
+*/
+const char statsFileName[] = "stats.json";
+/* record a timeline of the render and simulation threads from the first
+ * frame on, the T key starts and stops recording at any time. The spans
+ * are written to traceFileName on exit, open it in ui.perfetto.dev
+*/
+#define TRACE_MODE                  0
+const char traceFileName[] = "trace.json";
 /* grid dimension NxN
 */
 const int N = 800;
@@ -22,5 +46,32 @@ const int neighborhood = 5.0 * step;
 */
 #define RAPID_RANDOM_TREE           0
 #define RAPID_RANDOM_TREE_STAR      1
+/* sample the end cell instead of a uniform random cell goalBias
+ * percent of the time
+*/
+#define GOAL_BIASED_SAMPLING        0
+const int goalBias = 5;
+/* speculative batched extension, sample batchSize random nodes per
+ * step, find their nearest node and validate them in parallel against
+ * a frozen tree and then commit them in order
+*/
+#define BATCH_MODE                  0
+const int batchSize = 64;
+/* shared tree mode (RRT only), worker threads grow the same tree at
+ * once, the tree can hold at most sharedTreeCapacity nodes
+*/
+#define SHARED_TREE_MODE            0
+const int sharedTreeCapacity = 1 << 20;
+#if SHARED_TREE_MODE == 1 && RAPID_RANDOM_TREE_STAR == 1
+#error "SHARED_TREE_MODE only grows RRT trees, set RAPID_RANDOM_TREE instead"
+#endif
+/* write an image of the grid, tree and path every snapshotInterval
+ * simulation steps and at the end of every headless solve, rendered
+ * on the CPU at snapshotCellSize pixels per cell
+*/
+#define SNAPSHOT_MODE               0
+const int snapshotInterval = 1000;
+const int snapshotCellSize = 1;
+const char snapshotPrefix[] = "snapshot";
 #endif /* SIMULATION_CONSTANTS_H
 */
@@ -0,0 +1,82 @@
+#ifndef SIMULATION_PORTFOLIO_H
+#define SIMULATION_PORTFOLIO_H
+
+#include "../../Include/Simulation/RandomTree.h"
+#include <vector>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+
+/* one planner instance of the portfolio
+*/
+typedef struct{
+    plannerType planner;
+    int step;
+    int neighborhood;
+    unsigned int seed;
+    /* how the planner draws its random cells
+    */
+    samplerType sampler;
+}plannerConfig_t;
+
+/* FIRST_SOLUTION returns as soon as any planner finds a path, BEST_SOLUTION
+ * waits for all planners or the deadline and returns the lowest cost path
+*/
+typedef enum{
+    FIRST_SOLUTION,
+    BEST_SOLUTION
+}portfolioMode;
+
+typedef struct{
+    bool pathFound;
+    /* index into the portfolio configs of the planner that produced
+     * the path
+    */
+    int configIdx;
+    /* path length and time taken by that planner in seconds
+    */
+    float cost;
+    double timeToSolution;
+    /* node coords from end cell to start cell
+    */
+    std::vector<std::pair<int, int>> path;
+}portfolioResult_t;
+
+/* OR-parallel portfolio, runs independent planners on separate threads
+ * over one shared read-only grid. The planners that are still running
+ * are cancelled cooperatively once the result is decided
+*/
+class PortfolioClass{
+    private:
+        /* shared grid, holds only FREE and OBSTACLE cells
+        */
+        const int *cellMap;
+        int N;
+        std::vector<plannerConfig_t> configs;
+        /* state shared by the planner threads during a run, result and
+         * numDone are guarded by mtx. Once decided is set the result can
+         * no longer change
+        */
+        std::pair<int, int> startCell, endCell;
+        portfolioMode mode;
+        int maxIterations;
+        std::chrono::steady_clock::time_point startTime;
+        std::atomic<bool> cancel;
+        std::mutex mtx;
+        std::condition_variable cv;
+        portfolioResult_t result;
+        int numDone;
+        bool decided;
+
+        void runPlanner(int configIdx);
+
+    public:
+        PortfolioClass(const int *_cellMap, int _N, std::vector<plannerConfig_t> _configs);
+        ~PortfolioClass(void);
+
+        portfolioResult_t run(std::pair<int, int> start, std::pair<int, int> end,
+        portfolioMode _mode, double deadline, int _maxIterations);
+};
+#endif /* SIMULATION_PORTFOLIO_H
+*/
@@ -0,0 +1,81 @@
+#ifndef SIMULATION_QUERYPOOL_H
+#define SIMULATION_QUERYPOOL_H
+
+#include "../../Include/Simulation/Portfolio.h"
+#include <vector>
+#include <deque>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
+
+typedef struct{
+    /* caller assigned id, returned with the result
+    */
+    int id;
+    std::pair<int, int> start;
+    std::pair<int, int> end;
+}query_t;
+
+typedef struct{
+    int id;
+    bool pathFound;
+    float cost;
+    /* time taken to plan this query in seconds
+    */
+    double time;
+    /* node coords from end cell to start cell
+    */
+    std::vector<std::pair<int, int>> path;
+}queryResult_t;
+
+/* plans many start/end queries on one map. The grid is shared read-only
+ * by all workers, every worker owns a queue of queries and steals from
+ * the other queues once its own is empty. Every worker also owns an arena
+ * that is reset between queries, so the tree allocations of different
+ * queries never contend. Results are handed out as they finish
+*/
+class QueryPoolClass{
+    private:
+        const int *cellMap;
+        int N;
+        plannerConfig_t config;
+        int maxIterations;
+
+        int numThreads;
+        std::vector<std::thread> workers;
+        /* per worker queues, the owner pops from the back and thieves
+         * steal from the front
+        */
+        std::vector<std::deque<query_t>> queues;
+        std::mutex *queueMtx;
+        /* queries submitted but not yet picked up by a worker
+        */
+        std::atomic<int> numPending;
+        int nextQueue;
+        /* idle workers wait here for new queries
+        */
+        std::mutex workMtx;
+        std::condition_variable workCv;
+        bool stop;
+        /* finished results, numOutstanding is the number of submitted
+         * queries whose result has not been handed out yet
+        */
+        std::mutex resultMtx;
+        std::condition_variable resultCv;
+        std::deque<queryResult_t> results;
+        int numOutstanding;
+
+        bool popQuery(int workerIdx, query_t& query);
+        void worker(int workerIdx);
+
+    public:
+        QueryPoolClass(const int *_cellMap, int _N, plannerConfig_t _config, int _maxIterations,
+        int _numThreads);
+        ~QueryPoolClass(void);
+
+        void submit(const std::vector<query_t>& queries);
+        bool nextResult(queryResult_t& result);
+};
+#endif /* SIMULATION_QUERYPOOL_H
+*/
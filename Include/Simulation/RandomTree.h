@@ -3,7 +3,15 @@
 
 #include "../../Include/Visualization/Grid/Grid.h"
 #include "../../Include/Utils/Tree.h"
+#include "../../Include/Utils/SharedTree.h"
+#include "../../Include/Visualization/Snapshot/Snapshot.h"
+#include <string>
 #include <vector>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <random>
 
 /* all available states of a cell in the grid
 */
@@ -30,11 +38,60 @@ typedef enum{
     OTHER
 }widthType;
 
+/* node placement algorithm, used by the headless planner. The windowed
+ * simulation picks the algorithm with the options in Constants.h
+*/
+typedef enum{
+    RRT,
+    RRT_STAR
+}plannerType;
+
+/* how the random cell of an iteration is picked, GOAL_BIASED_SAMPLER
+ * returns the end cell instead of a uniform random cell goalBias
+ * percent of the time
+*/
+typedef enum{
+    UNIFORM_SAMPLER,
+    GOAL_BIASED_SAMPLER
+}samplerType;
+
+/* a speculative extension computed in the batch mode, the nearest
+ * node and validation are computed against a frozen snapshot of the
+ * tree and are committed serially later
+*/
+typedef struct{
+    std::pair<int, int> rNode;
+    std::pair<int, int> nearestNode;
+    std::pair<int, int> newNode;
+    /* set if the connection from nearest node to new node does not
+     * pass through any obstacle
+    */
+    bool valid;
+    /* set if the new node was overwritten with an end cell while
+     * validation
+    */
+    bool goalReached;
+}candidate_t;
+
 class RandomTreeClass: public GridClass, public TreeClass{
-    private:
+    /* the kernels are protected so that the benchmarks can time them
+     * through a subclass
+    */
+    protected:
         /* This will be the NxN grid that we will be working on
         */
         int *cellCurr;
+        /* all cell state reads go through cellMap, it points to cellCurr
+         * or to the shared read-only grid of a headless planner. The shared
+         * grid only holds FREE and OBSTACLE cells
+        */
+        const int *cellMap;
+        bool headless;
+        plannerType planner;
+        samplerType sampler;
+        /* random engine, seeded once per planner
+        */
+        std::default_random_engine randomEngine;
         /* this determines the next cell to set as NODE at a distance
          * along the line connected to random cell
         */
@@ -58,9 +115,18 @@ class RandomTreeClass: public GridClass, public TreeClass{
         /* final output boolean
         */
         bool pathFound;
+        /* set when the end cell is confirmed, a node of the existing
+         * tree may already be in the new end cell block
+        */
+        bool checkExistingPath;
         /* holds node coords from end cell to start cell
         */
         std::vector<std::pair<int, int>> path;
+        /* valid neighborhood nodes of the node being connected in RRT*,
+         * reserved for the most nodes that fit in a neighborhood so the
+         * planning loop does not allocate
+        */
+        std::vector<node_t*> neighborhoodNodes;
         /* other visual params
         */
         int otherCellHighlightWidth, endCellHighlightWidth, pathHighlightWidth;
@@ -68,31 +134,62 @@ class RandomTreeClass: public GridClass, public TreeClass{
         /* num random obstacles
         */
         int numObstacles;
+        /* batch mode, holds the speculative extensions for one batch and
+         * the nodes committed so far in the same batch
+        */
+        std::vector<candidate_t> candidates;
+        std::vector<std::pair<int, int>> batchNodes;
+        int numWorkers;
+        /* batch workers, started on the first batch and kept until the
+         * planner is destroyed. Every batch bumps batchGeneration to wake
+         * them, and the last one to finish its chunk wakes the planner
+        */
+        std::vector<std::thread> batchWorkers;
+        std::mutex batchMtx;
+        std::condition_variable batchCv, batchDoneCv;
+        long batchGeneration;
+        int numBatchWorkersBusy;
+        bool stopBatch;
+        /* shared tree mode, worker threads grow the shared tree against a
+         * snapshot of the grid and the nodes they publish are mirrored
+         * into the tree and the grid every step
+        */
+        SharedTreeClass *sharedTree;
+        std::vector<std::thread> treeWorkers;
+        std::atomic<bool> stopWorkers;
+        std::vector<int> cellSnapshot;
+        int numNodesMirrored;
+        /* CPU renderer for image snapshots, created on first use. The
+         * seed and the step count go into the snapshot file names
+        */
+        SnapshotClass *snapshot;
+        unsigned int plannerSeed;
+        long numSteps;
         
         /* util functions
         */
+        void initParams(int _step, int _neighborhood);
         int getIdx(int i, int j);
+        bool isCellEndCell(const int *cellMap, int i, int j);
         bool isCellFree(int i, int j);
         bool isCellObstacle(int i, int j);
         bool isCellEndCell(int i, int j);
+        colorVal getColorFromState(cellState state);
         void setCellColorFromState(int i, int j, cellState state, float alpha = 1.0);
         void setCellBlockToState(int i, int j, cellState state, int width);
         void setCellAsFree(int i, int j);
         void setCellBlockAsFree(int i, int j, int width);
         void setCellAsObstacle(int i, int j);
         void setCellAsNode(int i, int j);
-        void setCellAsNodeConnection(int i, int j);
         void setCellAsStartCell(int i, int j);
         void setCellAsEndCell(int i, int j);
         void setCellAsObstacleStream(int i1, int j1, int i2, int j2, const int width, 
         widthType wType);
-        void setCellAsNodeConnectionStream(int i1, int j1, int i2, int j2);
-        void clearNodeConnectionStream(int i1, int j1, int i2, int j2);
-        std::vector<std::pair<int, int> > connectTwoCells(int i1, int j1, int i2, int j2);
+        void connectTwoCells(int i1, int j1, int i2, int j2, std::vector<std::pair<int, int> >& points);
         void highlightCell(int i, int j, cellState state);
-        void highlightPath(std::vector<std::pair<int, int>> path, cellState state);
+        void highlightPath(const std::vector<std::pair<int, int>>& path);
         void deHighlightCell(int i, int j);
-        void deHighlightPath(std::vector<std::pair<int, int>> path);
+        void deHighlightPath(void);
         void restartRenderLoop(void);
         int getRandomAmount(int start, int end);
         float getDistanceBetweenCells(int i1, int j1, int i2, int j2);
@@ -102,24 +199,69 @@ class RandomTreeClass: public GridClass, public TreeClass{
         */
         std::pair<int, int> getRandomCell(void);
         std::pair<int, int> getNearestNode(std::pair<int, int> rNode);
+        bool isSegmentValid(const int *cellMap, std::pair<int, int> nearestNode, 
+        std::pair<int, int>& newNode, bool& goalReached);
+        bool isSegmentValid(std::pair<int, int> nearestNode, std::pair<int, int>& newNode,
+        bool& goalReached);
         bool isNodeValid(std::pair<int, int> nearestNode, std::pair<int, int>& newNode);
+        std::pair<int, int> computeNewNode(std::pair<int, int> rNode, 
+        std::pair<int, int> nearestNode);
         bool computeNewNodeAndValidate(std::pair<int, int> rNode, std::pair<int, int>& newNode);
         bool createAndConnectNewNode(std::pair<int, int> nearestNode, 
         std::pair<int, int> newNode);
+        bool connectNewNodeRRTStar(std::pair<int, int>& newNode);
         bool placeNodeRRT(std::pair<int, int> rNode, std::pair<int, int>& newNode);
         bool placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int, int>& newNode);
+        void computeCandidates(int start, int end);
+        void computeCandidatesChunk(int chunkIdx);
+        void batchWorker(int chunkIdx);
+        void startBatchWorkers(void);
+        void stopBatchWorkers(void);
+        bool revalidateCandidate(candidate_t& candidate);
+        bool placeNodesBatch(std::pair<int, int>& newNode);
+        void sharedTreeWorker(unsigned int seed);
+        void startSharedTreeWorkers(void);
+        void stopSharedTreeWorkers(void);
+        bool placeNodesShared(std::pair<int, int>& newNode);
+        bool isGoalReached(const int *cellMap, std::pair<int, int> dNode);
         bool isGoalReached(std::pair<int, int> dNode);
         bool isPathAlreadyExist(std::pair<int, int>& lastNode);
 
     public:
         RandomTreeClass(int _step, int _neighborhood, int _N, int _scale, bool noStroke);
+        /* headless planner over a shared read-only grid, no window is
+         * created. Many of these can plan over the same grid at once. The
+         * tree nodes are allocated from arena if one is given
+        */
+        RandomTreeClass(int _step, int _neighborhood, int _N, const int *sharedCells,
+        plannerType _planner, unsigned int seed, ArenaClass *arena = NULL);
         ~RandomTreeClass(void);
 
+        /* a planner samples uniformly unless told otherwise, set it
+         * before solve()
+        */
+        void setSampler(samplerType _sampler);
+        bool solve(std::pair<int, int> start, std::pair<int, int> end, int maxIterations,
+        const std::atomic<bool> *cancel, std::vector<std::pair<int, int>>& solvedPath);
+        /* headless growth without a goal, for benchmarks and tests. The
+         * end cell is put outside of the grid so that no iteration ever
+         * reaches it, the tree is rooted with createNode(). Every
+         * growOnce() is one iteration of the planner, it returns false
+         * if no node was added
+        */
+        void setNoGoal(void);
+        bool growOnce(void);
+        /* render the grid, the tree and the path on the CPU and write
+         * them to a .png or .ppm file (picked by extension), no window
+         * is needed. Returns false if the file could not be written
+        */
+        bool saveSnapshot(const std::string& fileName);
+
         /* override functions
         */
         void setObstacleCells(void);
         void setStartAndEndCells(void);
-        void simulationStep(void);
+        bool simulationStep(void);
 };
 #endif /* SIMULATION_RANDOMTREE_H
 */
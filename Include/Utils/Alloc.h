@@ -0,0 +1,40 @@
+#ifndef UTILS_ALLOC_H
+#define UTILS_ALLOC_H
+
+#include <cstdint>
+
+/* heap allocation accounting, global operator new and delete and, on
+ * glibc and macOS, malloc, calloc and realloc are replaced with versions
+ * that count the allocations of every thread. Off by default, build
+ * with -DALLOC_TRACKING=1 to count
+*/
+#ifndef ALLOC_TRACKING
+#define ALLOC_TRACKING              0
+#endif
+
+/* allocations and bytes requested by the calling thread so far, 0 if
+ * the allocations are not counted
+*/
+uint64_t allocGetCount(void);
+uint64_t allocGetBytes(void);
+
+/* counts the allocations of the calling thread from construction to
+ * the end of the scope, they are added to the run stats
+*/
+class AllocScopeClass{
+    private:
+        uint64_t startCount, startBytes;
+
+    public:
+        AllocScopeClass(void);
+        ~AllocScopeClass(void);
+        uint64_t getCount(void);
+};
+
+#if ALLOC_TRACKING == 1
+#define ALLOC_SCOPE(scope)              AllocScopeClass scope
+#else
+#define ALLOC_SCOPE(scope)              do{}while(0)
+#endif
+#endif /* UTILS_ALLOC_H
+*/
@@ -0,0 +1,85 @@
+#ifndef UTILS_ARENA_H
+#define UTILS_ARENA_H
+
+#include <cstddef>
+#include <new>
+
+/* header at the start of every arena block, the blocks form a list so
+ * that growing the arena only calls malloc for the block itself
+*/
+typedef struct arenaBlock{
+    struct arenaBlock *next;
+    /* usable bytes after the header
+    */
+    size_t size;
+}arenaBlock_t;
+
+/* bump allocator, memory is handed out from large blocks and is only
+ * given back all at once with reset(). The blocks are kept for reuse,
+ * so an arena that is reset between runs stops calling malloc once it
+ * has grown to the size of the largest run. An arena is not thread safe,
+ * every thread is expected to own its arena
+*/
+class ArenaClass{
+    private:
+        arenaBlock_t *firstBlock;
+        size_t blockSize;
+        /* block currently being handed out (NULL before the first
+         * allocation) and the offset into it
+        */
+        arenaBlock_t *currBlock;
+        size_t offset;
+        /* blocks malloc'd so far
+        */
+        int numBlocks;
+
+    public:
+        ArenaClass(size_t _blockSize);
+        ~ArenaClass(void);
+
+        void* allocate(size_t size, size_t align);
+        void reset(void);
+        /* bytes handed out since the last reset, alignment padding and
+         * the unused ends of full blocks included
+        */
+        size_t getUsedBytes(void);
+        /* number of mallocs the arena has done, the blocks are kept
+         * across resets
+        */
+        int getNumBlocks(void);
+};
+
+/* std allocator on top of an arena, falls back to the global heap if
+ * no arena is given. Deallocation is a no-op for arena memory
+*/
+template <typename T>
+struct arenaAllocator{
+    typedef T value_type;
+    ArenaClass *arena;
+
+    arenaAllocator(ArenaClass *_arena = NULL): arena(_arena){}
+    template <typename U>
+    arenaAllocator(const arenaAllocator<U>& other): arena(other.arena){}
+
+    T* allocate(size_t n){
+        if(arena == NULL)
+            return static_cast<T*>(::operator new(n * sizeof(T)));
+        return static_cast<T*>(arena->allocate(n * sizeof(T), alignof(T)));
+    }
+    void deallocate(T* p, size_t n){
+        if(arena == NULL)
+            ::operator delete(p, n * sizeof(T));
+    }
+};
+
+template <typename T, typename U>
+bool operator==(const arenaAllocator<T>& a, const arenaAllocator<U>& b){
+    return a.arena == b.arena;
+}
+
+template <typename T, typename U>
+bool operator!=(const arenaAllocator<T>& a, const arenaAllocator<U>& b){
+    return a.arena != b.arena;
+}
+#endif /* UTILS_ARENA_H
+*/
@@ -1,11 +1,15 @@
 #ifndef UTILS_COMMON_H
 #define UTILS_COMMON_H
 
-/* externs
+#include <atomic>
+
+/* externs, these are shared between the render thread (input) and
+ * the simulation thread
 */
-extern volatile bool stepMode;
-extern volatile bool readyToStart, startCellSet, endCellSet;
-extern double xPos, yPos;
-extern volatile bool mouseClicked;
+extern std::atomic<bool> stepMode;
+extern std::atomic<bool> readyToStart, startCellSet, endCellSet;
+extern std::atomic<double> xPos, yPos;
+extern std::atomic<bool> mouseClicked;
+extern std::atomic<double> scrollOffset;
 #endif /* UTILS_COMMON_H
 */
@@ -0,0 +1,112 @@
+#ifndef UTILS_LOG_H
+#define UTILS_LOG_H
+
+#include <atomic>
+#include <string>
+
+/* log levels, messages below LOG_LEVEL are removed at compile time,
+ * the arguments are not even evaluated. Build with for example
+ * -DLOG_LEVEL=LOG_LEVEL_TRACE to see every planner iteration
+*/
+#define LOG_LEVEL_TRACE             0
+#define LOG_LEVEL_DEBUG             1
+#define LOG_LEVEL_INFO              2
+#define LOG_LEVEL_WARN              3
+#define LOG_LEVEL_OFF               4
+#ifndef LOG_LEVEL
+#define LOG_LEVEL                   LOG_LEVEL_INFO
+#endif
+
+/* message categories, each one can be switched off at run time
+*/
+typedef enum{
+    LOG_PLANNER,
+    LOG_TREE,
+    LOG_GRID,
+    LOG_INPUT,
+    LOG_PROFILE
+}logCategory;
+
+/* one line of text, longer lines are cut
+*/
+static const int logLineSize = 120;
+typedef struct{
+    int level;
+    logCategory category;
+    int length;
+    char text[logLineSize];
+}logRecord_t;
+
+/* bit k set if category k is enabled, all are enabled by default
+*/
+extern std::atomic<unsigned> logCategoryMask;
+
+inline bool logEnabled(logCategory category){
+    return (logCategoryMask.load(std::memory_order_relaxed) >> category) & 1;
+}
+
+/* builds a line on the stack with <<, the line is queued when the
+ * object goes out of scope at the end of the log statement. Nothing
+ * is allocated
+*/
+class LogLineClass{
+    private:
+        logRecord_t record;
+        void append(const char *str, int length);
+
+    public:
+        LogLineClass(int level, logCategory category);
+        ~LogLineClass(void);
+
+        LogLineClass& operator<<(const char *value);
+        LogLineClass& operator<<(const std::string& value);
+        LogLineClass& operator<<(char value);
+        LogLineClass& operator<<(int value);
+        LogLineClass& operator<<(unsigned int value);
+        LogLineClass& operator<<(long value);
+        LogLineClass& operator<<(unsigned long value);
+        LogLineClass& operator<<(long long value);
+        LogLineClass& operator<<(unsigned long long value);
+        LogLineClass& operator<<(double value);
+};
+
+/* Messages go into a bounded lock free queue that any number of threads
+ * can push to, a background thread writes them to stdout. A full queue
+ * drops the message instead of blocking the caller, the number dropped
+ * is printed at exit
+*/
+void logSetCategories(unsigned mask);
+/* blocks until every message queued so far has been written and
+ * stdout flushed
+*/
+void logFlush(void);
+long logGetDropped(void);
+
+#define LOG_MESSAGE(level, category, message)                           \
+    do{                                                                 \
+        if(logEnabled(category))                                        \
+            LogLineClass(level, category)<<message;                     \
+    }while(0)
+
+#if LOG_LEVEL <= LOG_LEVEL_TRACE
+#define LOG_TRACE(category, message)    LOG_MESSAGE(LOG_LEVEL_TRACE, category, message)
+#else
+#define LOG_TRACE(category, message)    do{}while(0)
+#endif
+#if LOG_LEVEL <= LOG_LEVEL_DEBUG
+#define LOG_DEBUG(category, message)    LOG_MESSAGE(LOG_LEVEL_DEBUG, category, message)
+#else
+#define LOG_DEBUG(category, message)    do{}while(0)
+#endif
+#if LOG_LEVEL <= LOG_LEVEL_INFO
+#define LOG_INFO(category, message)     LOG_MESSAGE(LOG_LEVEL_INFO, category, message)
+#else
+#define LOG_INFO(category, message)     do{}while(0)
+#endif
+#if LOG_LEVEL <= LOG_LEVEL_WARN
+#define LOG_WARN(category, message)     LOG_MESSAGE(LOG_LEVEL_WARN, category, message)
+#else
+#define LOG_WARN(category, message)     do{}while(0)
+#endif
+#endif /* UTILS_LOG_H
+*/
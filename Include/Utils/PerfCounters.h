@@ -0,0 +1,41 @@
+#ifndef UTILS_PERFCOUNTERS_H
+#define UTILS_PERFCOUNTERS_H
+
+#include <cstdint>
+
+/* hardware counters of the calling thread, read with perf_event_open
+ * on Linux. Off by default, build with -DPERF_COUNTERS=1 to count them
+ * per stats phase. A read is a system call, so the phase times of such
+ * a build are higher. Where a counter cannot be opened (not Linux, no
+ * PMU access in a container or VM, perf_event_paranoid) it is left out
+ * and the phases are still timed. If the kernel has to share the PMU
+ * between more counters than it has, the counts are scaled estimates
+*/
+#ifndef PERF_COUNTERS
+#define PERF_COUNTERS               0
+#endif
+
+typedef enum{
+    PERF_CYCLES,
+    PERF_INSTRUCTIONS,
+    PERF_CACHE_MISSES,
+    PERF_BRANCH_MISSES,
+    NUM_PERF_EVENTS
+}perfEvent;
+
+/* current counts of the calling thread, its counters are opened on the
+ * first call. An event that could not be opened reads 0. Returns false
+ * if none of the events could be opened
+*/
+bool perfRead(uint64_t values[NUM_PERF_EVENTS]);
+/* set if every thread that opened its counters so far could open this
+ * event
+*/
+bool perfIsEventAvailable(perfEvent event);
+/* set once a read had to be scaled because the counters were not
+ * running the whole time
+*/
+bool perfIsMultiplexed(void);
+const char* perfGetEventName(perfEvent event);
+#endif /* UTILS_PERFCOUNTERS_H
+*/
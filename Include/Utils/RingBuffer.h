@@ -0,0 +1,78 @@
+#ifndef UTILS_RINGBUFFER_H
+#define UTILS_RINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+
+/* lock free single producer single consumer ring buffer. Exactly one
+ * thread may push and exactly one other thread may pop. The capacity
+ * is rounded up to a power of 2. Each side keeps a cached copy of the
+ * other side's index, so the shared indices are only read when the ring
+ * looks full (or empty)
+*/
+template <typename T>
+class RingBufferClass{
+    private:
+        T *buffer;
+        size_t capacity;
+        size_t mask;
+        /* head is the next slot to write, tail is the next slot to read.
+         * They are kept on separate cache lines to avoid false sharing
+         * between the producer and consumer
+        */
+        alignas(64) std::atomic<size_t> head;
+        size_t cachedTail;
+        alignas(64) std::atomic<size_t> tail;
+        size_t cachedHead;
+
+    public:
+        RingBufferClass(size_t _capacity){
+            capacity = 1;
+            while(capacity < _capacity)
+                capacity <<= 1;
+            mask = capacity - 1;
+            buffer = new T[capacity];
+            head.store(0, std::memory_order_relaxed);
+            tail.store(0, std::memory_order_relaxed);
+            cachedTail = 0;
+            cachedHead = 0;
+        }
+
+        ~RingBufferClass(void){
+            delete[] buffer;
+        }
+
+        /* producer only, returns false if the ring is full
+        */
+        bool push(const T& item){
+            size_t h = head.load(std::memory_order_relaxed);
+            if(h - cachedTail == capacity){
+                cachedTail = tail.load(std::memory_order_acquire);
+                if(h - cachedTail == capacity)
+                    return false;
+            }
+            buffer[h & mask] = item;
+            head.store(h + 1, std::memory_order_release);
+            return true;
+        }
+
+        /* consumer only, returns false if the ring is empty
+        */
+        bool pop(T& item){
+            size_t t = tail.load(std::memory_order_relaxed);
+            if(t == cachedHead){
+                cachedHead = head.load(std::memory_order_acquire);
+                if(t == cachedHead)
+                    return false;
+            }
+            item = buffer[t & mask];
+            tail.store(t + 1, std::memory_order_release);
+            return true;
+        }
+
+        size_t size(void){
+            return head.load(std::memory_order_acquire) - tail.load(std::memory_order_acquire);
+        }
+};
+#endif /* UTILS_RINGBUFFER_H
+*/
@@ -0,0 +1,72 @@
+#ifndef UTILS_SHAREDTREE_H
+#define UTILS_SHAREDTREE_H
+
+#include <vector>
+#include <atomic>
+
+/* node of the shared tree, the parent link is set with a release store
+ * and the node is only visible to readers once ready is set
+*/
+typedef struct sharedNode{
+    /* node coordinates
+    */
+    std::pair<int, int> pos;
+    /* parent of the node
+    */
+    std::atomic<struct sharedNode*> parent;
+    /* next node in the same nearest node bucket
+    */
+    std::atomic<struct sharedNode*> next;
+    /* set after the node is completely written
+    */
+    std::atomic<bool> ready;
+}sharedNode_t;
+
+/* tree that can be grown by several threads at once. Nodes are appended
+ * into a preallocated array using an atomic counter, a cell can hold only
+ * one node which is claimed with a compare and swap, and the nearest node
+ * index is a coarse grid of lock free lists, so readers never block while
+ * other threads are inserting
+*/
+class SharedTreeClass{
+    private:
+        /* preallocated node array and the number of slots reserved
+        */
+        sharedNode_t *nodes;
+        int capacity;
+        std::atomic<int> numReserved;
+        /* grid dimension NxN
+        */
+        int N;
+        /* cell to node slot, EMPTY_CELL if there is no node at this cell
+         * and CLAIMED_CELL while a node is being inserted
+        */
+        std::atomic<int> *cellToNode;
+        /* nearest node index, each bucket holds the nodes that are within
+         * a bucketDim x bucketDim block of cells
+        */
+        int bucketDim, numBuckets;
+        std::atomic<sharedNode_t*> *buckets;
+
+        int getIdx(int i, int j);
+        int getBucketIdx(int bi, int bj);
+        float getDistance(std::pair<int, int> a, std::pair<int, int> b);
+
+    public:
+        SharedTreeClass(int _N, int _capacity, int _bucketDim);
+        ~SharedTreeClass(void);
+
+        static const int EMPTY_CELL = -1;
+        static const int CLAIMED_CELL = -2;
+
+        int insertNode(std::pair<int, int> cellPos, int parentIdx);
+        int getNearestNode(std::pair<int, int> cellPos);
+        int getNodeIdx(sharedNode_t* node);
+        int getNumReserved(void);
+        bool isNodeReady(int idx);
+        std::pair<int, int> getNodePos(int idx);
+        int getParentIdx(int idx);
+        bool verifyIntegrity(void);
+};
+#endif /* UTILS_SHAREDTREE_H
+*/
@@ -0,0 +1,121 @@
+#ifndef UTILS_STATS_H
+#define UTILS_STATS_H
+
+#include <atomic>
+#include <chrono>
+#include <string>
+#include <cstdint>
+#include "../../Include/Utils/PerfCounters.h"
+
+/* phase timers and event counters of the planning loop, cheap enough to
+ * be left on. Build with -DSTATS_ENABLED=0 to remove them
+*/
+#ifndef STATS_ENABLED
+#define STATS_ENABLED               1
+#endif
+
+/* phases of a simulation step, the time of a phase does not include
+ * the phases timed inside it (a collision check during parent selection
+ * is collision time)
+*/
+typedef enum{
+    PHASE_SAMPLE,
+    PHASE_NEAREST,
+    PHASE_STEER,
+    PHASE_COLLISION,
+    PHASE_PARENT,
+    PHASE_REWIRE,
+    PHASE_PATH,
+    PHASE_COLOR,
+    PHASE_UPLOAD,
+    NUM_PHASES
+}statsPhase;
+
+typedef enum{
+    COUNT_ITERATIONS,
+    COUNT_SAMPLES_REJECTED,
+    COUNT_NODE_EXISTS,
+    COUNT_INVALID_NODE,
+    COUNT_REROUTES,
+    COUNT_NODES_ADDED,
+    /* only counted in builds with ALLOC_TRACKING
+    */
+    COUNT_ALLOCATIONS,
+    COUNT_ALLOCATED_BYTES,
+    NUM_COUNTERS
+}statsCounter;
+
+/* Every thread adds to its own block, so there is no contention and
+ * an update is a plain load and store. The blocks of exited threads
+ * are folded into a global total
+*/
+typedef struct{
+    std::atomic<uint64_t> phaseTime[NUM_PHASES];
+    std::atomic<uint64_t> phaseCalls[NUM_PHASES];
+    /* hardware counts, only counted in builds with PERF_COUNTERS
+    */
+    std::atomic<uint64_t> phaseEvents[NUM_PHASES][NUM_PERF_EVENTS];
+    std::atomic<uint64_t> counters[NUM_COUNTERS];
+}statsBlock_t;
+
+/* sum over all threads, times in nanoseconds
+*/
+typedef struct{
+    uint64_t phaseTime[NUM_PHASES];
+    uint64_t phaseCalls[NUM_PHASES];
+    uint64_t phaseEvents[NUM_PHASES][NUM_PERF_EVENTS];
+    uint64_t counters[NUM_COUNTERS];
+}statsSnapshot_t;
+
+statsBlock_t* statsGetBlock(void);
+
+inline void statsAdd(std::atomic<uint64_t>& value, uint64_t amount){
+    value.store(value.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+}
+
+inline void statsCount(statsCounter counter, uint64_t amount = 1){
+    statsAdd(statsGetBlock()->counters[counter], amount);
+}
+
+/* times a phase from construction to stop() or the end of the scope,
+ * the time (and hardware counts) of timers started inside it is taken
+ * out
+*/
+class PhaseTimerClass{
+    private:
+        statsPhase phase;
+        bool running;
+        std::chrono::steady_clock::time_point start;
+        uint64_t childTime;
+        PhaseTimerClass *parent;
+#if PERF_COUNTERS == 1
+        uint64_t startEvents[NUM_PERF_EVENTS];
+        uint64_t childEvents[NUM_PERF_EVENTS];
+#endif
+
+    public:
+        PhaseTimerClass(statsPhase _phase);
+        ~PhaseTimerClass(void);
+        void stop(void);
+};
+
+statsSnapshot_t statsGetSnapshot(void);
+void statsReset(void);
+const char* statsGetPhaseName(statsPhase phase);
+const char* statsGetCounterName(statsCounter counter);
+/* phase times, calls and counters as a JSON object, with the hardware
+ * counts of every phase if they were counted
+*/
+bool statsWriteJSON(const std::string& fileName);
+
+#if STATS_ENABLED == 1
+#define STATS_PHASE(timer, phase)       PhaseTimerClass timer(phase)
+#define STATS_STOP(timer)               timer.stop()
+#define STATS_COUNT(counter)            statsCount(counter)
+#else
+#define STATS_PHASE(timer, phase)       do{}while(0)
+#define STATS_STOP(timer)               do{}while(0)
+#define STATS_COUNT(counter)            do{}while(0)
+#endif
+#endif /* UTILS_STATS_H
+*/
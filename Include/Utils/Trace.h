@@ -0,0 +1,74 @@
+#ifndef UTILS_TRACE_H
+#define UTILS_TRACE_H
+
+#include <atomic>
+#include <string>
+#include <cstdint>
+
+/* timeline of scoped spans per thread, written as a Chrome trace
+ * (chrome://tracing, ui.perfetto.dev). Recording is switched on and off
+ * at run time, a span that is not recorded costs a relaxed load and a
+ * branch. Build with -DTRACE_ENABLED=0 to remove the spans
+*/
+#ifndef TRACE_ENABLED
+#define TRACE_ENABLED               1
+#endif
+
+/* one finished span, times in nanoseconds since the trace started
+*/
+typedef struct{
+    const char *name;
+    uint64_t start;
+    uint64_t duration;
+}traceEvent_t;
+
+extern std::atomic<bool> traceActive;
+
+inline bool traceEnabled(void){
+    return traceActive.load(std::memory_order_relaxed);
+}
+
+void traceStart(void);
+void traceStop(void);
+/* names the calling thread in the trace
+*/
+void traceSetThreadName(const char *name);
+uint64_t traceNow(void);
+void traceRecord(const char *name, uint64_t start, uint64_t end);
+long traceGetDropped(void);
+/* writes every span recorded so far, returns false if there were none
+ * or the file could not be written. Meant to be called once the traced
+ * threads are done
+*/
+bool traceWriteJSON(const std::string& fileName);
+
+/* records the time from construction to the end of the scope, the
+ * name must outlive the trace (a string literal)
+*/
+class TraceSpanClass{
+    private:
+        const char *name;
+        uint64_t start;
+        bool recording;
+
+    public:
+        TraceSpanClass(const char *_name){
+            recording = traceEnabled();
+            if(recording){
+                name = _name;
+                start = traceNow();
+            }
+        }
+        ~TraceSpanClass(void){
+            if(recording)
+                traceRecord(name, start, traceNow());
+        }
+};
+
+#if TRACE_ENABLED == 1
+#define TRACE_SPAN(span, name)          TraceSpanClass span(name)
+#else
+#define TRACE_SPAN(span, name)          do{}while(0)
+#endif
+#endif /* UTILS_TRACE_H
+*/
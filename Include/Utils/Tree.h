@@ -1,6 +1,7 @@
 #ifndef UTILS_TREE_H
 #define UTILS_TREE_H
 
+#include "../../Include/Utils/Arena.h"
 #include <vector>
 #include <map>
 
@@ -13,29 +14,50 @@ typedef struct node{
     struct node *parent;
 }node_t;
 
+/* cell coords to node map, the map nodes come from the tree's arena
+*/
+typedef std::map<std::pair<int, int>, node_t*, std::less<std::pair<int, int>>,
+arenaAllocator<std::pair<const std::pair<int, int>, node_t*>>> nodeMap_t;
+
 class TreeClass{
     private:
         /* the root node will be the start cell
         */
         node_t *root;
+        /* nodes and map entries are allocated from this arena, a tree
+         * that is not given one owns an arena of its own, so adding a
+         * node only calls malloc once per arena block
+        */
+        static const size_t arenaBlockSize = 1 << 20;
+        ArenaClass *ownedArena;
+        ArenaClass *arena;
 
     protected:
         /* the map keeps account of all the nodes
         */
-        std::map<std::pair<int, int>, node_t*> mp;
+        nodeMap_t mp;
 
         void showMap(void);
         node_t* getNodeFromCell(int i, int j);
-        std::vector<std::pair<int, int>> getPath(std::pair<int, int> lastAddedNode);
+        void getPath(std::pair<int, int> lastAddedNode, std::vector<std::pair<int, int>>& solvedPath);
+        /* blocks the tree's arena has malloc'd so far
+        */
+        int getNumArenaBlocks(void);
 
     public:
-        TreeClass(void);
+        TreeClass(ArenaClass *_arena = NULL);
         ~TreeClass(void);
 
         bool createNode(std::pair<int, int> cellPos);
         bool addEdge(node_t* source, node_t* dest);
         bool removeEdge(node_t* source, node_t* dest);
         float getDistanceToRoot(node_t* dest);
+        int getNumNodes(void);
 };
+
+/* length of a path of cell coords, every segment is measured the same
+ * way as the edge between a node and its parent
+*/
+float getPathCost(const std::vector<std::pair<int, int>>& path);
 #endif /* UTILS_TREE_H
 */
@@ -45,13 +45,24 @@
  * which is plenty enough for our purposes.
 */
 #include <GLFW/glfw3.h>
+#include "../../../Include/Utils/RingBuffer.h"
 #include <vector>
+#include <unordered_map>
+#include <thread>
+#include <atomic>
+#include <mutex>
+#include <condition_variable>
+#include <string>
+#include <fstream>
+#include <chrono>
 
-/* enum to decide the type of data to be processed
+/* enum to decide the type of data to be processed, COLOR is the
+ * cell state texture, EDGE and PATH are the line overlay
 */
 typedef enum{
-    VERTEX, 
-    COLOR
+    COLOR,
+    EDGE,
+    PATH
 }dataType;
 /* struct to represent color RGB
 */
@@ -60,13 +71,65 @@ typedef struct{
     float G;
     float B;
 }colorVal;
+/* color change of a cell made by the simulation thread, applied
+ * to the cell states by the render thread
+*/
+typedef struct{
+    int i;
+    int j;
+    colorVal cVal;
+    float alpha;
+}cellUpdate_t;
+/* change to the line overlay made by the simulation thread. EDGE_LINE
+ * adds or moves the edge ending at (i2,j2), PATH_LINE appends a path 
+ * segment and PATH_CLEAR removes the path
+*/
+typedef enum{
+    EDGE_LINE,
+    PATH_LINE,
+    PATH_CLEAR
+}lineLayer;
+
+typedef struct{
+    lineLayer layer;
+    int i1;
+    int j1;
+    int i2;
+    int j2;
+}lineUpdate_t;
+
+/* output of the frame capture, a numbered PPM file per frame or all 
+ * frames appended to one raw RGB file (top row first)
+*/
+typedef enum{
+    CAPTURE_PPM,
+    CAPTURE_RAW
+}captureFormat;
 
 /* 2D grid class that abstracts all openGl funcitonalities 
  * required to set up and run render
 */
 class GridClass{
     private:
+        /* max number of distinct cell colors, must match the palette 
+         * size in the fragment shader
+        */
+        static const int maxPaletteSize = 32;
+        /* the window is never larger than this (pixels), bigger grids
+         * are viewed through the camera
+        */
+        static const int maxWindowDim = 1024;
+        /* number of pixel buffer objects the frame capture cycles
+         * through, and number of frames after its read back that a PBO
+         * is mapped. The PBOs that are neither in flight nor mapped are
+         * the frames that can wait for the writer
+        */
+        static const int captureRingSize = 8;
+        static const int captureMapDelay = 2;
         int scale;
+        /* window width and height in pixels
+        */
+        int windowDim;
         /* all cells within the grid will be made up of the same 
          * size; cellDim x cellDim
         */ 
@@ -79,30 +142,78 @@ class GridClass{
          * won't).
         */        
         float axisMin, axisMax;
-        /* As input to the graphics pipeline we pass in a list
-         * of 3D coordinates that should form the desired shape
-         * in an array here called VERTEX DATA; this vertex data 
-         * is a collection of vertices. 
-         * 
-         * A vertex is a collection of data per 3D coordinate. 
-         * This vertex's data is represented using VERTEX 
-         * ATTRIBUTES that can contain any data we'd like.
+        /* one byte per cell, the palette index of the cell color.
+         * This is uploaded as a NxN R8UI texture and the fragment
+         * shader looks up the color in the palette uniform, so a
+         * cell costs 1 byte on the GPU. The grid itself has no
+         * vertex data, the vertex shader makes up the corners of
+         * a quad covering the screen
+        */
+        unsigned char *cellStates;
+        /* Level of detail pyramid for zoomed out views. Level 0 is
+         * cellStates, every texel of level k covers 2x2 texels of
+         * level k-1 and keeps the color of the first one that is not
+         * the background, so thin obstacles and nodes don't vanish.
+         * A level is kept up to date as cells change
+        */
+        std::vector<unsigned char*> levels;
+        std::vector<int> levelDims;
+        /* The camera, viewX and viewY is the grid position (in cells)
+         * at the lower left of the window and viewSize the number of 
+         * cells across the window. They are written by the render thread
+         * and read when a click is mapped to a cell
+        */
+        std::atomic<double> viewX, viewY, viewSize;
+        bool viewChanged;
+        /* Only the visible part of the grid is in the GPU texture, at 
+         * the level where it fits in the window. This is the level and 
+         * the texel rectangle (in that level) that is in the texture
+        */
+        int textureDim;
+        int viewLevel, viewTexX, viewTexY, viewTexW, viewTexH;
+        /* RGBA palette, entries are added the first time a color
+         * and alpha combination is used
+        */
+        float palette[4 * maxPaletteSize];
+        int paletteSize;
+        /* last palette entry that matched
+        */
+        int lastPaletteIdx;
+        bool paletteDirty;
+        /* level 0 cells changed since the last upload, kept as one span of
+         * columns per texture row, and the range of rows that have a
+         * span. Only the spans are uploaded
         */
-        std::vector<float> vertices;
-        /* These indices tells the order to draw the quad using 
-         * 4 vertices using EBO
+        std::vector<int> dirtySpanMin, dirtySpanMax;
+        int dirtyRowMin, dirtyRowMax;
+        /* bytes of cell states uploaded in the last frame and in total
         */
-        std::vector<unsigned int> indices;
-        /* RGBA format, define the color for all the grid cells.
-         * We are not using vector here since we need to index
-         * into a specific cell to set the colors. It is easier
-         * to do this with arrays
+        long frameUploadBytes, totalUploadBytes;
+        /* draw the cell borders
         */
-        float *color;
-        /* Total #of elements in color array = 
-         * 4 (RGBA) * 4(vertices per cell) * N * N
+        bool stroke;
+        /* Line overlay, tree edges and the solution path are drawn as 
+         * lines over the grid instead of being rasterized into cells.
+         * Every edge is 2 vertices (x,y) in edgeVertices, at the slot
+         * given by its child cell, so a rewired edge is moved in place.
+         * Only the slots changed since the last upload are uploaded
         */
-        int colorArraySize;
+        std::vector<float> edgeVertices;
+        std::unordered_map<int, int> edgeSlots;
+        int edgeDirtyMin, edgeDirtyMax;
+        /* number of floats the GPU edge buffer has room for
+        */
+        size_t edgeBufferCapacity;
+        /* the path is drawn as a thick line, each segment is a quad
+         * made of 2 triangles
+        */
+        std::vector<float> pathVertices;
+        bool pathDirty;
+        colorVal edgeColor, pathColor;
+        float edgeAlpha, pathAlpha;
+        /* path width in cells on either side of the path
+        */
+        int pathWidth;
         /* With the vertex data defined we'd like to send it as
          * input to the first process of the graphics pipeline: 
          * the vertex shader.
@@ -126,19 +237,87 @@ class GridClass{
          * card's memory the vertex shader has almost instant 
          * access to the vertices making it extremely fast
          *  
-         * We will also be using EBO, An EBO is a buffer, just 
-         * like a vertex buffer object, that stores indices 
-         * that OpenGL uses to decide what vertices to draw. 
-         * This also called indexed drawing. This can help us
-         * reduce the number of vertices to define when drawing
-         * quads using triangles
-         * 
-         * We will be using two VBOs, one for vertices and the
-         * other for color
+         * The cell states live in a texture object, textureCells,
+         * the grid quad only needs an empty VAO
          */
-        unsigned int VBOVertex, VBOColor, VAO, EBO;
+        unsigned int VAO, textureCells;
+        /* buffers for the line overlay
+        */
+        unsigned int VBOEdge, VAOEdge, VBOPath, VAOPath;
         GLFWwindow* window;
+        /* When the simulation runs on its own thread, it never touches
+         * the cell states. Color changes are pushed into this ring and
+         * the render thread drains it once per frame
+        */
+        bool simulationThreaded;
+        RingBufferClass<cellUpdate_t> *cellUpdates;
+        RingBufferClass<lineUpdate_t> *lineUpdates;
+        std::thread simulationThread;
+        std::atomic<bool> stopSimulation;
+        /* time budget (seconds) for the simulation steps of one frame, and
+         * the measured cost of one step which decides how many steps are
+         * run between clock reads
+        */
+        double frameBudget;
+        double iterationCost;
+        /* frame timer, duration of the last frame and a running average
+         * (seconds)
+        */
+        double lastFrameTime, avgFrameTime;
+        long numFrames;
+        /* when the window was created, the time to the first frame is
+         * the start up cost
+        */
+        std::chrono::steady_clock::time_point startTime;
+        /* step mode and trace key states, a key acts once per press
+        */
+        bool stepKeyDown, traceKeyDown;
+        /* render on demand, a frame is only drawn if something on
+         * screen changed. When idle the render thread blocks for up to
+         * idleWaitTime seconds waiting for events, renderWaiting tells
+         * the simulation thread to wake it up. The simulation thread 
+         * in turn sleeps on inputChanged while it has nothing to do
+        */
+        bool frameDirty;
+        std::atomic<bool> renderWaiting;
+        double idleWaitTime;
+        std::mutex inputMtx;
+        std::condition_variable inputChanged;
+        /* Frame capture, every drawn frame is read back with glReadPixels
+         * into a pixel buffer object, which returns without waiting for
+         * the GPU. The PBO is mapped captureMapDelay frames later when
+         * the copy is long done, and the mapped slot is handed to the
+         * writer thread through captureQueue, which writes straight from
+         * the mapping. Slots the writer is done with come back through
+         * captureDone and are unmapped by the render thread. If the next
+         * PBO is still with the writer the frame is dropped instead of
+         * stalling the render loop
+        */
+        bool captureRequested, capturing, captureKeyDown;
+        std::string capturePrefix;
+        captureFormat captureFmt;
+        int captureWidth, captureHeight;
+        unsigned int capturePBOs[captureRingSize];
+        GLsync captureFences[captureRingSize];
+        /* frames read into a PBO and frames mapped so far
+        */
+        long captureIssued, captureMapped;
+        unsigned char *captureMaps[captureRingSize];
+        bool captureSlotBusy[captureRingSize];
+        RingBufferClass<int> *captureQueue, *captureDone;
+        std::thread captureThread;
+        std::atomic<bool> stopCaptureWriter;
+        std::mutex captureMtx;
+        std::condition_variable captureReady;
+        /* frames written (numbers the files), dropped and times the
+         * render thread had to wait for a PBO, and the average frame 
+         * time while capturing
+        */
+        long captureFrameId, captureDropped, captureStalls;
+        double captureFrameTime;
+        long numCaptureFrames;
 
+        void initParams(int _N, int _scale);
         GLFWwindow* openGLBringUp(void);
         void genBufferObjects(void);
         void moveDataToGPU(dataType dtType);
@@ -146,9 +325,30 @@ class GridClass{
         void processInput(GLFWwindow* window);
         void openGLClose(void);
 
-        void genCellVertices(float i, float j);
-        void genCellVerticesWrapper(int i, int j);
-        int getEboIdx(int i, int j);
+        int getPaletteIdx(colorVal cVal, float alpha);
+        void applyCellColor(int i, int j, colorVal cVal, float alpha);
+        void clearDirtySpans(void);
+        void getCellCenter(int i, int j, float& x, float& y);
+        void pushLineUpdate(lineUpdate_t update);
+        void applyLineUpdate(lineUpdate_t update);
+        void uploadCellStates(int x, int y, int width, int height);
+        void uploadDirtyRect(int x, int y, int width, int height);
+        void updateLevels(int i, int j);
+        void getViewRegion(int& level, int& x, int& y, int& width, int& height);
+        void zoomView(double factor, double pivotX, double pivotY);
+        void panView(double dx, double dy);
+        void clampView(void);
+        bool drainCellUpdates(void);
+        void waitForEvents(void);
+        void simulationLoop(void);
+        bool simulationFrame(void);
+        void beginCapture(void);
+        void endCapture(void);
+        void captureFrame(void);
+        void mapCaptureSlot(int slot);
+        void releaseCaptureSlots(void);
+        void captureWriterLoop(void);
+        void writeCaptureFrame(const unsigned char *pixels, std::ofstream& rawFile);
 
     protected:
         /* the grid will be made up of NxN cells, the scale
@@ -163,16 +363,40 @@ class GridClass{
         colorVal redVal, greenVal, blueVal, blackVal, whiteVal;
 
         void genCellColor(int i, int j, colorVal cVal, float alpha);
+        void genEdgeLine(std::pair<int, int> parent, std::pair<int, int> child);
+        void genPathLines(const std::vector<std::pair<int, int>>& path);
+        void setLineStyle(colorVal _edgeColor, float _edgeAlpha, colorVal _pathColor, 
+        float _pathAlpha, int _pathWidth);
         void mouseAction(double mouseXPos, double mouseYPos);
 
         virtual void setObstacleCells(void) = 0;
         virtual void setStartAndEndCells(void) = 0;
-        virtual void simulationStep(void) = 0;
+        /* returns false if there was nothing to simulate
+        */
+        virtual bool simulationStep(void) = 0;
 
     public:
         GridClass(int _N, int _scale, bool noStroke);
-        ~GridClass(void);
-        void runRender(void);
+        /* headless grid, no window or GPU buffers are created and the
+         * cell states are not allocated
+        */
+        GridClass(int _N);
+        virtual ~GridClass(void);
+        /* if _simulationThreaded is set, the simulation runs on its own
+         * thread at full speed. Otherwise it runs on the render thread for
+         * up to _frameBudget milliseconds per frame, or one step per frame
+         * if the budget is 0
+        */
+        void runRender(bool _simulationThreaded = false, double _frameBudget = 0);
+        double getAverageFrameTime(void);
+        /* bytes of cell states uploaded to the GPU in the last frame
+        */
+        long getFrameUploadBytes(void);
+        /* record the window to prefix_NNNNNN.ppm files or to prefix.raw,
+         * from the first frame on. The C key starts and stops recording
+         * while running
+        */
+        void startCapture(const std::string& prefix, captureFormat format = CAPTURE_PPM);
 };
 #endif /* VISUALIZATION_GRID_H
 */
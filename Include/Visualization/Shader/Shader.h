@@ -57,14 +57,49 @@
  * a vertex and fragment shader of our own (there are 
  * no default vertex/fragment shaders on the GPU).
 */
+/* GRID_SHADER draws the cells, LINE_SHADER draws the line overlay in
+ * a single color
+*/
+typedef enum{
+    GRID_SHADER,
+    LINE_SHADER
+}shaderType;
+
+/* uniforms of both shaders, the setters take one of these so setting
+ * a uniform is an array lookup
+*/
+typedef enum{
+    UNIFORM_CELL_STATES,
+    UNIFORM_STROKE,
+    UNIFORM_GRID_SIZE,
+    UNIFORM_LOD_LEVEL,
+    UNIFORM_TEX_ORIGIN,
+    UNIFORM_VIEW_ORIGIN,
+    UNIFORM_VIEW_SIZE,
+    UNIFORM_PALETTE,
+    UNIFORM_LINE_COLOR,
+    NUM_UNIFORMS
+}shaderUniform;
+
 class ShaderClass{
     private:
-        /* shader file paths
+        /* location of every uniform, filled once after linking. -1 for
+         * the uniforms this program does not have
+        */
+        int uniformLocations[NUM_UNIFORMS];
+        /* Linked programs are cached on disk with glGetProgramBinary, the
+         * file name is a hash of the driver (vendor, renderer, version)
+         * and the shader sources, so a driver update or a shader change 
+         * never loads a stale binary. The cache lives in a directory
+         * only the user can access, $XDG_CACHE_HOME/RandomTree or
+         * ~/.cache/RandomTree. Drivers that report no binary formats
+         * always compile
         */
-        const char* vertexPath = 
-        "/Users/vijoys/Downloads/Projects/RandomTree/Source/Visualization/Shader/ShaderVert.sdr";
-        const char* fragmentPath = 
-        "/Users/vijoys/Downloads/Projects/RandomTree/Source/Visualization/Shader/ShaderFrag.sdr";
+        std::string getCachePath(const char *vShaderCode, const char *fShaderCode);
+        bool loadProgramBinary(const std::string& cachePath);
+        void saveProgramBinary(const std::string& cachePath);
+        void compileProgram(const char *vShaderCode, const char *fShaderCode);
+        void loadUniformLocations(void);
         /* Check compilation errors after compiling shaders
          * and linking errors after linking a shader program
         */
@@ -73,10 +108,13 @@ class ShaderClass{
         /* id for the shader program object
         */
         unsigned int ID;
-        /* Constructor that takes in the file paths for vertex
-         * and fragment shaders source code
+        /* set if the program was loaded from the binary cache
+        */
+        bool fromCache;
+        /* Constructor that builds the program from the embedded vertex
+         * and fragment shader sources of the given shader type
         */
-        ShaderClass();
+        ShaderClass(shaderType type = GRID_SHADER);
         /* Activate a shader program object referenced by ID
         */
         void use(void); 
@@ -98,10 +136,13 @@ class ShaderClass{
          * simply pick the overloaded function that corresponds 
          * with your type.
         */
-        void setBool(const std::string &name, bool value) const;
-        void setInt(const std::string &name, int value) const;
-        void setFloat(const std::string &name, float value) const;
-        void setVec4(const std::string &name, float x, float y, float z, float w) const;
+        void setBool(shaderUniform uniform, bool value) const;
+        void setInt(shaderUniform uniform, int value) const;
+        void setFloat(shaderUniform uniform, float value) const;
+        void setVec2(shaderUniform uniform, float x, float y) const;
+        void setIVec2(shaderUniform uniform, int x, int y) const;
+        void setVec4(shaderUniform uniform, float x, float y, float z, float w) const;
+        void setVec4Array(shaderUniform uniform, int count, const float *value) const;
 };
 #endif /* VISUALIZATION_SHADER_H
 */
\ No newline at end of file
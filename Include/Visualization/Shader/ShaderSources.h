@@ -0,0 +1,22 @@
+#ifndef VISUALIZATION_SHADERSOURCES_H
+#define VISUALIZATION_SHADERSOURCES_H
+
+/* The shader sources are compiled into the program, every .sdr file
+ * holds a single raw string literal so it can be included as the
+ * initializer of a string. Nothing is read from disk at run time and
+ * the executable can be started from any directory
+*/
+static const char *gridVertexSource =
+#include "../../../Source/Visualization/Shader/ShaderVert.sdr"
+;
+static const char *gridFragmentSource =
+#include "../../../Source/Visualization/Shader/ShaderFrag.sdr"
+;
+static const char *lineVertexSource =
+#include "../../../Source/Visualization/Shader/LineVert.sdr"
+;
+static const char *lineFragmentSource =
+#include "../../../Source/Visualization/Shader/LineFrag.sdr"
+;
+#endif /* VISUALIZATION_SHADERSOURCES_H
+*/
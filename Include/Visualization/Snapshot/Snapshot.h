@@ -0,0 +1,75 @@
+#ifndef VISUALIZATION_SNAPSHOT_H
+#define VISUALIZATION_SNAPSHOT_H
+
+#include <vector>
+#include <string>
+#include <cstdint>
+
+/* 8 bit RGBA color of the snapshot
+*/
+typedef struct{
+    unsigned char R;
+    unsigned char G;
+    unsigned char B;
+    unsigned char A;
+}rgba_t;
+
+/* a line between two cells, (i,j) coords
+*/
+typedef std::pair<std::pair<int, int>, std::pair<int, int>> snapshotLine_t;
+
+/* CPU renderer, draws a grid of cell states, the tree edges and the
+ * path into an RGBA image laid out like the window: cell (i,j) at
+ * column i and row j counted from the bottom, cellSize pixels wide.
+ * No GL context or display is needed, so planner output of headless
+ * runs can be looked at. The output only depends on the input, two
+ * renders of the same state are equal byte for byte
+*/
+class SnapshotClass{
+    private:
+        int N;
+        int cellSize;
+        int imageDim;
+        int numThreads;
+        /* color of each cell state value, any value out of range is
+         * drawn with the first entry
+        */
+        std::vector<uint32_t> palette;
+        /* line overlay style, same as the window
+        */
+        rgba_t edgeColor, pathColor;
+        int pathWidth;
+        /* RGBA pixels, top row first
+        */
+        std::vector<uint32_t> image;
+        /* cell colors at one pixel per cell, used when cellSize > 1
+        */
+        std::vector<uint32_t> cellImage;
+
+        uint32_t packColor(rgba_t color);
+        void fillCells(const int *cells, uint32_t *out, int jStart, int jEnd);
+        void scaleRows(int yStart, int yEnd);
+        void getCellCenter(std::pair<int, int> cell, float& x, float& y);
+        void blendPixel(int x, int y, rgba_t color);
+        void drawLine(std::pair<int, int> from, std::pair<int, int> to, rgba_t color);
+        void drawThickLine(std::pair<int, int> from, std::pair<int, int> to, rgba_t color);
+
+    public:
+        SnapshotClass(int _N, int _cellSize, const std::vector<rgba_t>& _palette,
+        int _numThreads = 0);
+
+        void setLineStyle(rgba_t _edgeColor, rgba_t _pathColor, int _pathWidth);
+        /* cells holds NxN cell state values, indexed i + j * N
+        */
+        void render(const int *cells, const std::vector<snapshotLine_t>& edges,
+        const std::vector<std::pair<int, int>>& path);
+
+        int getImageDim(void);
+        /* RGBA bytes, imageDim x imageDim, top row first
+        */
+        const unsigned char* getPixels(void);
+        bool writePPM(const std::string& fileName);
+        bool writePNG(const std::string& fileName);
+};
+#endif /* VISUALIZATION_SNAPSHOT_H
+*/
@@ -0,0 +1,87 @@
+#include "../../Include/Benchmark/Benchmark.h"
+#include <cstdio>
+#include <algorithm>
+
+BenchStateClass::BenchStateClass(long _iterations){
+    iterations = _iterations;
+    itemsPerOp = 1;
+    elapsed = 0;
+    running = false;
+}
+
+long BenchStateClass::getIterations(void){
+    return iterations;
+}
+
+void BenchStateClass::setItemsPerOp(double items){
+    itemsPerOp = items;
+}
+
+double BenchStateClass::getItemsPerOp(void){
+    return itemsPerOp;
+}
+
+void BenchStateClass::pause(void){
+    if(!running)
+        return;
+    elapsed += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    running = false;
+}
+
+void BenchStateClass::resume(void){
+    if(running)
+        return;
+    running = true;
+    start = std::chrono::steady_clock::now();
+}
+
+double BenchStateClass::getElapsed(void){
+    return elapsed;
+}
+
+BenchmarkClass::BenchmarkClass(double _minTime){
+    minTime = _minTime;
+}
+
+void BenchmarkClass::add(const std::string& name, std::function<void(BenchStateClass&)> fn){
+    benchmarks.push_back({name, fn});
+}
+
+benchResult_t BenchmarkClass::runOne(benchmark_t& benchmark){
+    long iterations = 1;
+    while(true){
+        BenchStateClass state(iterations);
+        state.resume();
+        benchmark.fn(state);
+        state.pause();
+        double elapsed = state.getElapsed();
+        /* long enough, or grow the count to what should take about
+         * 1.4 times minTime, at most 10x per round
+        */
+        if(elapsed >= minTime || iterations >= 1000000000L){
+            benchResult_t result;
+            result.name = benchmark.name;
+            result.iterations = iterations;
+            result.nsPerOp = elapsed * 1e9/iterations;
+            result.itemsPerSec = iterations * state.getItemsPerOp()/elapsed;
+            return result;
+        }
+        double scale = elapsed <= 0 ? 10 : std::min(1.4 * minTime/elapsed, 10.0);
+        iterations = std::max(iterations + 1, (long)(iterations * scale));
+    }
+}
+
+std::vector<benchResult_t> BenchmarkClass::run(const std::string& filter){
+    std::vector<benchResult_t> results;
+    printf("%-40s %12s %14s %14s\n", "Benchmark", "Iterations", "ns/op", "items/sec");
+    for(int k = 0; k < benchmarks.size(); k++){
+        if(benchmarks[k].name.find(filter) == std::string::npos)
+            continue;
+        benchResult_t result = runOne(benchmarks[k]);
+        printf("%-40s %12ld %14.1f %14.4g\n", result.name.c_str(), result.iterations,
+        result.nsPerOp, result.itemsPerSec);
+        fflush(stdout);
+        results.push_back(result);
+    }
+    return results;
+}
@@ -0,0 +1,206 @@
+#include "../../Include/Benchmark/PlannerBench.h"
+#include "../../Include/Simulation/Constants.h"
+#include <random>
+#include <string>
+#include <stdlib.h>
+
+namespace{
+    const unsigned int benchSeed = 1;
+}
+
+/* step and neighborhood would name the planner's own members here, the
+ * settings from Constants.h are the global ones
+*/
+KernelPlannerClass::KernelPlannerClass(int N, std::vector<int>& cells, plannerType planner):
+RandomTreeClass(::step, ::neighborhood, N, cells.data(), planner, benchSeed){
+    setNoGoal();
+}
+
+const int* KernelPlannerClass::useOwnGrid(void){
+    cellCurr = (int*)calloc(N * N, sizeof(int));
+    cellMap = cellCurr;
+    headless = false;
+    return cellCurr;
+}
+
+PlannerBenchClass::PlannerBenchClass(void){
+    largeCells.assign(largeN * largeN, FREE);
+    planCells.assign(planN * planN, FREE);
+}
+
+PlannerBenchClass::~PlannerBenchClass(void){
+    for(auto it = nearestTrees.begin(); it != nearestTrees.end(); it++)
+        delete it->second;
+}
+
+/* numNodes nodes on distinct random cells
+*/
+KernelPlannerClass* PlannerBenchClass::getNearestTree(int numNodes){
+    if(nearestTrees.count(numNodes) != 0)
+        return nearestTrees[numNodes];
+
+    KernelPlannerClass *p = new KernelPlannerClass(largeN, largeCells, RRT);
+    std::vector<int> cellIdx(largeN * largeN);
+    for(int k = 0; k < cellIdx.size(); k++)
+        cellIdx[k] = k;
+    std::mt19937 rng(numNodes);
+    for(int k = 0; k < numNodes; k++){
+        std::swap(cellIdx[k], cellIdx[k + rng() % (cellIdx.size() - k)]);
+        p->createNode(std::make_pair(cellIdx[k] % largeN, cellIdx[k] / largeN));
+    }
+    nearestTrees[numNodes] = p;
+    return p;
+}
+
+void PlannerBenchClass::benchNearestNode(BenchStateClass& state, int numNodes){
+    state.pause();
+    KernelPlannerClass *p = getNearestTree(numNodes);
+    std::mt19937 rng(benchSeed);
+    state.resume();
+    for(long k = 0; k < state.getIterations(); k++)
+        benchKeep(p->getNearestNode(std::make_pair(rng() % largeN, rng() % largeN)));
+    state.setItemsPerOp(numNodes);
+}
+
+void PlannerBenchClass::benchConnectTwoCells(BenchStateClass& state, int length){
+    state.pause();
+    KernelPlannerClass *p = new KernelPlannerClass(planN, planCells, RRT);
+    std::vector<std::pair<int, int>> points;
+    state.resume();
+    for(long k = 0; k < state.getIterations(); k++){
+        p->connectTwoCells(100, 100, 100 + length, 100, points);
+        benchKeep(points.data());
+    }
+    state.pause();
+    delete p;
+    state.setItemsPerOp(length);
+}
+
+void PlannerBenchClass::benchNodeValid(BenchStateClass& state, int length){
+    state.pause();
+    KernelPlannerClass *p = new KernelPlannerClass(planN, planCells, RRT);
+    std::pair<int, int> nearestNode = std::make_pair(100, 100);
+    state.resume();
+    for(long k = 0; k < state.getIterations(); k++){
+        std::pair<int, int> newNode = std::make_pair(100 + length, 100);
+        benchKeep(p->isNodeValid(nearestNode, newNode));
+    }
+    state.pause();
+    delete p;
+    state.setItemsPerOp(length);
+}
+
+/* a chain of depth nodes, the distance is taken from its far end
+*/
+void PlannerBenchClass::benchDistanceToRoot(BenchStateClass& state, int depth){
+    state.pause();
+    KernelPlannerClass *p = new KernelPlannerClass(largeN, largeCells, RRT);
+    node_t *prev = NULL;
+    for(int k = 0; k < depth; k++){
+        p->createNode(std::make_pair(k / largeN, k % largeN));
+        node_t *curr = p->getNodeFromCell(k / largeN, k % largeN);
+        p->addEdge(prev, curr);
+        prev = curr;
+    }
+    state.resume();
+    for(long k = 0; k < state.getIterations(); k++)
+        benchKeep(p->getDistanceToRoot(prev));
+    state.pause();
+    delete p;
+    state.setItemsPerOp(depth);
+}
+
+void PlannerBenchClass::benchRandomAmount(BenchStateClass& state){
+    state.pause();
+    KernelPlannerClass *p = new KernelPlannerClass(planN, planCells, RRT);
+    state.resume();
+    for(long k = 0; k < state.getIterations(); k++)
+        benchKeep(p->getRandomAmount(0, planN - 1));
+    state.pause();
+    delete p;
+}
+
+/* the block is set and freed in turn, so every call writes all of its
+ * cells. The planner gets a grid of its own to write to, a headless
+ * grid has no colors so only the cell states are written
+*/
+void PlannerBenchClass::benchCellBlockToState(BenchStateClass& state, int width){
+    state.pause();
+    KernelPlannerClass *p = new KernelPlannerClass(planN, planCells, RRT);
+    const int *cells = p->useOwnGrid();
+    state.resume();
+    for(long k = 0; k < state.getIterations(); k++)
+        p->setCellBlockToState(planN/2, planN/2, k % 2 == 0 ? END_CELL : FREE, width);
+    state.pause();
+    benchKeep(cells[planN/2 * planN + planN/2]);
+    delete p;
+    state.setItemsPerOp((2 * width + 1) * (2 * width + 1));
+}
+
+/* one sample, nearest node, steer, validation and insertion (and the
+ * rewire for RRT*), averaged over trees grown from the root up to
+ * treeIterations iterations
+*/
+void PlannerBenchClass::benchIteration(BenchStateClass& state, plannerType planner){
+    RandomTreeClass *p = NULL;
+    for(long k = 0; k < state.getIterations(); k++){
+        if(k % treeIterations == 0){
+            state.pause();
+            delete p;
+            p = new RandomTreeClass(step, neighborhood, planN, planCells.data(), planner, benchSeed);
+            p->setNoGoal();
+            p->createNode(std::make_pair(planN/2, planN/2));
+            state.resume();
+        }
+        p->growOnce();
+    }
+    state.pause();
+    delete p;
+}
+
+void PlannerBenchClass::addBenchmarks(BenchmarkClass& bench){
+    const int nodeCounts[] = {1000, 10000, 100000, 1000000};
+    const char *nodeNames[] = {"1k", "10k", "100k", "1M"};
+    for(int k = 0; k < 4; k++){
+        int numNodes = nodeCounts[k];
+        bench.add(std::string("getNearestNode/") + nodeNames[k], [this, numNodes](BenchStateClass& state){
+            benchNearestNode(state, numNodes);
+        });
+    }
+    const int lengths[] = {10, 100, 500};
+    for(int k = 0; k < 3; k++){
+        int length = lengths[k];
+        bench.add("connectTwoCells/" + std::to_string(length), [this, length](BenchStateClass& state){
+            benchConnectTwoCells(state, length);
+        });
+    }
+    for(int k = 0; k < 3; k++){
+        int length = lengths[k];
+        bench.add("isNodeValid/" + std::to_string(length), [this, length](BenchStateClass& state){
+            benchNodeValid(state, length);
+        });
+    }
+    const int depths[] = {10, 100, 1000, 10000};
+    for(int k = 0; k < 4; k++){
+        int depth = depths[k];
+        bench.add("getDistanceToRoot/" + std::to_string(depth), [this, depth](BenchStateClass& state){
+            benchDistanceToRoot(state, depth);
+        });
+    }
+    bench.add("getRandomAmount", [this](BenchStateClass& state){
+        benchRandomAmount(state);
+    });
+    const int widths[] = {1, 8, 32};
+    for(int k = 0; k < 3; k++){
+        int width = widths[k];
+        bench.add("setCellBlockToState/" + std::to_string(width), [this, width](BenchStateClass& state){
+            benchCellBlockToState(state, width);
+        });
+    }
+    bench.add("iteration/RRT", [this](BenchStateClass& state){
+        benchIteration(state, RRT);
+    });
+    bench.add("iteration/RRT*", [this](BenchStateClass& state){
+        benchIteration(state, RRT_STAR);
+    });
+}
@@ -0,0 +1,222 @@
+#include "../../Include/Benchmark/ScalingStudy.h"
+#include "../../Include/Simulation/Constants.h"
+#include "../../Include/Utils/Arena.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdlib.h>
+
+namespace{
+    const unsigned int studySeed = 1;
+    const long maxNodes = 1024000;
+    const int gridSizes[] = {800, 1600, 3200, 6400, 12800, 25600, 32000};
+    const int threadCounts[] = {1, 2, 4, 8, 16, 32, 64};
+
+    double getElapsed(std::chrono::steady_clock::time_point start){
+        return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+
+    /* FREE is 0, so a calloc'd grid is empty and the pages of a large
+     * grid are only backed once the planner reads them
+    */
+    int* newEmptyGrid(int N){
+        return (int*)calloc((size_t)N * N, sizeof(int));
+    }
+}
+
+ScalingStudyClass::ScalingStudyClass(double _budget){
+    budget = _budget;
+}
+
+void ScalingStudyClass::iterate(RandomTreeClass& p, std::vector<double>& latencies){
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    p.growOnce();
+    latencies.push_back(getElapsed(start) * 1e6);
+}
+
+/* the cost of an iteration is the core time it takes, the threads of
+ * the thread series share the cores of the machine
+*/
+void ScalingStudyClass::addPoint(scalingPoint_t point, std::vector<double>& latencies){
+    std::sort(latencies.begin(), latencies.end());
+    point.p50 = latencies.size() == 0 ? 0 : latencies[latencies.size()/2];
+    point.p99 = latencies.size() == 0 ? 0 : latencies[latencies.size() * 99/100];
+    point.exponent = 0;
+    point.superLinear = false;
+
+    static int numCores = std::max(1, (int)std::thread::hardware_concurrency());
+    auto getCost = [](const scalingPoint_t& pt){
+        int parallel = pt.study == "threads" ? std::min((long)numCores, pt.size) : 1;
+        return pt.seconds * parallel/pt.iterations;
+    };
+    for(int k = points.size() - 1; k >= 0 && !point.skipped && point.iterations > 0; k--){
+        const scalingPoint_t& prev = points[k];
+        if(prev.study != point.study || prev.planner != point.planner)
+            break;
+        if(prev.skipped || prev.iterations == 0)
+            continue;
+        point.exponent = log(getCost(point)/getCost(prev))/log((double)point.size/prev.size);
+        point.superLinear = point.exponent > maxExponent;
+        break;
+    }
+    points.push_back(point);
+
+    if(point.skipped){
+        printf("%-8s %-5s %9ld  skipped\n", point.study.c_str(), point.planner.c_str(), point.size);
+        return;
+    }
+    printf("%-8s %-5s %9ld %9ld %12.0f %10.2f %10.2f %12zu %8.2f %s\n", point.study.c_str(),
+    point.planner.c_str(), point.size, point.nodes, point.iterations/point.seconds, point.p50,
+    point.p99, point.memory, point.exponent, point.superLinear ? "SUPER-LINEAR" : "");
+    fflush(stdout);
+}
+
+/* one tree grows from the center until it has maxNodes nodes, a point
+ * is taken every time the node count doubles
+*/
+void ScalingStudyClass::studyNodes(plannerType planner){
+    const char *plannerName = planner == RRT ? "RRT" : "RRT*";
+    int *cells = newEmptyGrid(treeN);
+    ArenaClass arena(1 << 20);
+    RandomTreeClass p(step, neighborhood, treeN, cells, planner, studySeed, &arena);
+    p.setNoGoal();
+    p.createNode(std::make_pair(treeN/2, treeN/2));
+    std::vector<double> latencies;
+    std::chrono::steady_clock::time_point seriesStart = std::chrono::steady_clock::now();
+
+    for(long target = 1000; target <= maxNodes; target *= 2){
+        latencies.clear();
+        long iterations = 0;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        while(p.getNumNodes() < target && getElapsed(seriesStart) < budget){
+            iterate(p, latencies);
+            iterations++;
+        }
+        scalingPoint_t point = {"nodes", plannerName, target, p.getNumNodes(), iterations,
+        getElapsed(start), 0, 0, arena.getUsedBytes(), 0, false, p.getNumNodes() < target};
+        addPoint(point, latencies);
+        if(point.skipped){
+            std::cout<<"nodes "<<plannerName<<": stopped at "<<p.getNumNodes()<<" nodes after "
+                     <<budget<<" s"<<std::endl;
+            break;
+        }
+    }
+    free(cells);
+}
+
+/* pointIterations iterations of a tree grown from the center at every
+ * grid size, a grid that cannot be allocated is skipped
+*/
+void ScalingStudyClass::studyGrid(void){
+    std::vector<double> latencies;
+    std::chrono::steady_clock::time_point seriesStart = std::chrono::steady_clock::now();
+    for(int k = 0; k < sizeof(gridSizes)/sizeof(int) && getElapsed(seriesStart) < budget; k++){
+        int N = gridSizes[k];
+        scalingPoint_t point = {"grid", "RRT", N, 0, 0, 0, 0, 0, 0, 0, false, true};
+        latencies.clear();
+        int *cells = newEmptyGrid(N);
+        if(cells == NULL){
+            addPoint(point, latencies);
+            continue;
+        }
+        {
+            ArenaClass arena(1 << 20);
+            RandomTreeClass p(step, neighborhood, N, cells, RRT, studySeed, &arena);
+            p.setNoGoal();
+            p.createNode(std::make_pair(N/2, N/2));
+            std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+            for(int i = 0; i < pointIterations; i++)
+                iterate(p, latencies);
+            point.seconds = getElapsed(start);
+            point.iterations = pointIterations;
+            point.nodes = p.getNumNodes();
+            point.memory = (size_t)N * N * sizeof(int) + arena.getUsedBytes();
+            point.skipped = false;
+        }
+        free(cells);
+        addPoint(point, latencies);
+    }
+}
+
+/* every thread grows a tree of its own for pointIterations iterations
+ * over one shared grid, with an arena of its own
+*/
+void ScalingStudyClass::studyThreads(void){
+    int *cells = newEmptyGrid(treeN);
+    std::chrono::steady_clock::time_point seriesStart = std::chrono::steady_clock::now();
+    for(int k = 0; k < sizeof(threadCounts)/sizeof(int) && getElapsed(seriesStart) < budget; k++){
+        int numThreads = threadCounts[k];
+        std::vector<std::vector<double>> threadLatencies(numThreads);
+        std::vector<size_t> threadMemory(numThreads);
+        std::vector<long> threadNodes(numThreads);
+        std::vector<std::thread> workers;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        for(int t = 0; t < numThreads; t++){
+            workers.push_back(std::thread([this, cells, t, &threadLatencies, &threadMemory,
+            &threadNodes]{
+                ArenaClass arena(1 << 20);
+                RandomTreeClass p(step, neighborhood, treeN, cells, RRT, studySeed + t, &arena);
+                p.setNoGoal();
+                p.createNode(std::make_pair(treeN/2, treeN/2));
+                threadLatencies[t].reserve(pointIterations);
+                for(int i = 0; i < pointIterations; i++)
+                    iterate(p, threadLatencies[t]);
+                threadMemory[t] = arena.getUsedBytes();
+                threadNodes[t] = p.getNumNodes();
+            }));
+        }
+        for(int t = 0; t < numThreads; t++)
+            workers[t].join();
+
+        scalingPoint_t point = {"threads", "RRT", numThreads, 0, (long)numThreads * pointIterations,
+        getElapsed(start), 0, 0, 0, 0, false, false};
+        std::vector<double> latencies;
+        for(int t = 0; t < numThreads; t++){
+            latencies.insert(latencies.end(), threadLatencies[t].begin(), threadLatencies[t].end());
+            point.memory += threadMemory[t];
+            point.nodes += threadNodes[t];
+        }
+        addPoint(point, latencies);
+    }
+    free(cells);
+}
+
+void ScalingStudyClass::run(void){
+    points.clear();
+    printf("%-8s %-5s %9s %9s %12s %10s %10s %12s %8s\n", "Study", "Plan", "Size", "Nodes",
+    "Iter/s", "p50 us", "p99 us", "Memory", "Exponent");
+    studyNodes(RRT);
+    studyNodes(RRT_STAR);
+    studyGrid();
+    studyThreads();
+
+    for(int k = 0; k < points.size(); k++){
+        if(points[k].superLinear)
+            std::cout<<"Super-linear: "<<points[k].study<<" "<<points[k].planner<<" at "
+                     <<points[k].size<<", cost per iteration ~ size^"<<points[k].exponent<<std::endl;
+    }
+}
+
+bool ScalingStudyClass::writeCSV(const std::string& fileName){
+    std::ofstream file(fileName);
+    if(!file){
+        std::cout<<"[ERROR] Could not open "<<fileName<<std::endl;
+        return false;
+    }
+    file<<"study,planner,size,nodes,iterations,seconds,iterations_per_sec,ns_per_iteration,"
+          "p50_us,p99_us,memory_bytes,bytes_per_node,exponent,super_linear,skipped\n";
+    for(int k = 0; k < points.size(); k++){
+        const scalingPoint_t& pt = points[k];
+        bool valid = !pt.skipped && pt.iterations > 0;
+        file<<pt.study<<","<<pt.planner<<","<<pt.size<<","<<pt.nodes<<","<<pt.iterations<<","
+            <<pt.seconds<<","<<(valid ? pt.iterations/pt.seconds : 0)<<","
+            <<(valid ? pt.seconds * 1e9/pt.iterations : 0)<<","<<pt.p50<<","<<pt.p99<<","
+            <<pt.memory<<","<<(pt.nodes > 0 && pt.study == "nodes" ? (double)pt.memory/pt.nodes : 0)
+            <<","<<pt.exponent<<","<<pt.superLinear<<","<<pt.skipped<<"\n";
+    }
+    return file.good();
+}
@@ -0,0 +1,23 @@
+#include "../../Include/Benchmark/Benchmark.h"
+#include "../../Include/Benchmark/PlannerBench.h"
+#include "../../Include/Benchmark/ScalingStudy.h"
+#include <stdlib.h>
+
+/* usage: Benchmark.exe [filter] [min time per benchmark in seconds]
+ *        Benchmark.exe scaling <csv file> [seconds per series]
+*/
+int main(int argc, char **argv){
+    if(argc > 2 && std::string(argv[1]) == "scaling"){
+        ScalingStudyClass study(argc > 3 ? atof(argv[3]) : 60.0);
+        study.run();
+        return study.writeCSV(argv[2]) ? 0 : 1;
+    }
+    std::string filter = argc > 1 ? argv[1] : "";
+    double minTime = argc > 2 ? atof(argv[2]) : 0.5;
+
+    BenchmarkClass bench(minTime);
+    PlannerBenchClass plannerBench;
+    plannerBench.addBenchmarks(bench);
+    bench.run(filter);
+    return 0;
+}
@@ -0,0 +1,409 @@
+#include "../../Include/Scenario/Scenario.h"
+#include "../../Include/Simulation/RandomTree.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iomanip>
+#include <random>
+#include <queue>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+
+namespace{
+    const char *typeNames[NUM_SCENARIO_TYPES] = {
+        "open", "clutter", "maze", "narrow", "bugtrap"
+    };
+    const int corpusSizes[] = {200, 400, 800};
+    const unsigned int corpusSeeds[] = {1, 2};
+    const int numQueries = 4;
+
+    /* std::mt19937 gives the same sequence everywhere, the std
+     * distributions do not, so ranges are taken with a modulo
+    */
+    class ScenarioRandomClass{
+        private:
+            std::mt19937 engine;
+
+        public:
+            ScenarioRandomClass(unsigned int seed): engine(seed){}
+
+            /* in [lo, hi]
+            */
+            int uniform(int lo, int hi){
+                return lo + engine() % (hi - lo + 1);
+            }
+    };
+
+    /* fills [i0, i1] x [j0, j1], clipped to the grid
+    */
+    void fillRect(scenario_t& s, int i0, int j0, int i1, int j1, int state){
+        i0 = std::max(i0, 0);       j0 = std::max(j0, 0);
+        i1 = std::min(i1, s.N - 1); j1 = std::min(j1, s.N - 1);
+        for(int j = j0; j <= j1; j++){
+            for(int i = i0; i <= i1; i++)
+                s.cells[i + j * s.N] = state;
+        }
+    }
+
+    void addBorder(scenario_t& s){
+        int width = std::max(1, s.N/200);
+        fillRect(s, 0, 0, s.N - 1, width - 1, OBSTACLE);
+        fillRect(s, 0, s.N - width, s.N - 1, s.N - 1, OBSTACLE);
+        fillRect(s, 0, 0, width - 1, s.N - 1, OBSTACLE);
+        fillRect(s, s.N - width, 0, s.N - 1, s.N - 1, OBSTACLE);
+    }
+
+    /* random rectangles until a quarter of the grid is blocked
+    */
+    void genClutter(scenario_t& s, ScenarioRandomClass& rng){
+        long blocked = 0, target = (long)s.N * s.N/4;
+        for(int attempt = 0; attempt < 10000 && blocked < target; attempt++){
+            int w = rng.uniform(s.N/40, s.N/10);
+            int h = rng.uniform(s.N/40, s.N/10);
+            int i = rng.uniform(0, s.N - w);
+            int j = rng.uniform(0, s.N - h);
+            for(int y = j; y < j + h; y++){
+                for(int x = i; x < i + w; x++){
+                    if(s.cells[x + y * s.N] == FREE)
+                        blocked++;
+                }
+            }
+            fillRect(s, i, j, i + w - 1, j + h - 1, OBSTACLE);
+        }
+    }
+
+    /* perfect maze of M x M rooms carved with a depth first search, the
+     * walls are a quarter of a room thick
+    */
+    void genMaze(scenario_t& s, ScenarioRandomClass& rng){
+        const int M = 12;
+        int room = s.N/M;
+        int wall = std::max(1, room/4);
+        fillRect(s, 0, 0, s.N - 1, s.N - 1, OBSTACLE);
+
+        std::vector<bool> visited(M * M, false);
+        std::vector<int> stack;
+        stack.push_back(0);
+        visited[0] = true;
+        fillRect(s, wall, wall, room - 1, room - 1, FREE);
+        while(stack.size() != 0){
+            int curr = stack.back();
+            int a = curr % M, b = curr / M;
+            int next[4], numNext = 0;
+            if(a > 0 && !visited[curr - 1])         next[numNext++] = curr - 1;
+            if(a < M - 1 && !visited[curr + 1])     next[numNext++] = curr + 1;
+            if(b > 0 && !visited[curr - M])         next[numNext++] = curr - M;
+            if(b < M - 1 && !visited[curr + M])     next[numNext++] = curr + M;
+            if(numNext == 0){
+                stack.pop_back();
+                continue;
+            }
+            int n = next[rng.uniform(0, numNext - 1)];
+            int na = n % M, nb = n / M;
+            /* the room and the wall between it and the current room
+            */
+            fillRect(s, na * room + wall, nb * room + wall, (na + 1) * room - 1, (nb + 1) * room - 1, FREE);
+            if(na != a)
+                fillRect(s, std::max(a, na) * room, b * room + wall, std::max(a, na) * room + wall - 1,
+                         (b + 1) * room - 1, FREE);
+            else
+                fillRect(s, a * room + wall, std::max(b, nb) * room, (a + 1) * room - 1,
+                         std::max(b, nb) * room + wall - 1, FREE);
+            visited[n] = true;
+            stack.push_back(n);
+        }
+    }
+
+    /* walls across the grid, each with one narrow gap
+    */
+    void genNarrow(scenario_t& s, ScenarioRandomClass& rng){
+        const int numWalls = 4;
+        int thickness = std::max(2, s.N/100);
+        int gap = std::max(2, s.N/100);
+        for(int w = 0; w < numWalls; w++){
+            int i = s.N * (w + 1)/(numWalls + 1);
+            int gapStart = rng.uniform(s.N/10, s.N - s.N/10 - gap);
+            fillRect(s, i, 0, i + thickness - 1, gapStart - 1, OBSTACLE);
+            fillRect(s, i, gapStart + gap, i + thickness - 1, s.N - 1, OBSTACLE);
+        }
+    }
+
+    /* a cup that opens away from the goal side with its lips bent in,
+     * the start is inside the cup. Returns the inside of the cup
+    */
+    void genBugTrap(scenario_t& s, ScenarioRandomClass& rng, int& i0, int& j0, int& i1, int& j1){
+        int size = s.N/4;
+        int thickness = std::max(2, s.N/100);
+        int ci = s.N/3 + rng.uniform(-s.N/20, s.N/20);
+        int cj = s.N/2 + rng.uniform(-s.N/20, s.N/20);
+        int left = ci - size/2, right = ci + size/2;
+        int bottom = cj - size/2, top = cj + size/2;
+        /* back of the cup faces the goal, the lips leave a gap of a
+         * quarter of the cup
+        */
+        fillRect(s, right - thickness + 1, bottom, right, top, OBSTACLE);
+        fillRect(s, left, bottom, right, bottom + thickness - 1, OBSTACLE);
+        fillRect(s, left, top - thickness + 1, right, top, OBSTACLE);
+        fillRect(s, left, bottom, left + thickness - 1, cj - size/8, OBSTACLE);
+        fillRect(s, left, cj + size/8, left + thickness - 1, top, OBSTACLE);
+        i0 = left + thickness;      j0 = bottom + thickness;
+        i1 = right - thickness;     j1 = top - thickness;
+    }
+
+    /* shortest 8-connected path length from start to goal, diagonal
+     * steps may not cut an obstacle corner. FLT_MAX if there is none
+    */
+    float getGridOptimal(const scenario_t& s, std::pair<int, int> start, std::pair<int, int> goal){
+        typedef std::pair<float, int> item_t;
+        std::vector<float> dist(s.N * s.N, FLT_MAX);
+        std::priority_queue<item_t, std::vector<item_t>, std::greater<item_t>> open;
+        int startIdx = start.first + start.second * s.N;
+        int goalIdx = goal.first + goal.second * s.N;
+        dist[startIdx] = 0;
+        open.push(std::make_pair(0.0f, startIdx));
+        while(open.size() != 0){
+            item_t top = open.top();
+            open.pop();
+            int idx = top.second;
+            if(top.first > dist[idx])
+                continue;
+            if(idx == goalIdx)
+                return top.first;
+            int i = idx % s.N, j = idx / s.N;
+            for(int dj = -1; dj <= 1; dj++){
+                for(int di = -1; di <= 1; di++){
+                    int ni = i + di, nj = j + dj;
+                    if((di == 0 && dj == 0) || ni < 0 || nj < 0 || ni >= s.N || nj >= s.N)
+                        continue;
+                    if(s.cells[ni + nj * s.N] == OBSTACLE)
+                        continue;
+                    if(di != 0 && dj != 0 && (s.cells[ni + j * s.N] == OBSTACLE ||
+                    s.cells[i + nj * s.N] == OBSTACLE))
+                        continue;
+                    float d = top.first + (di != 0 && dj != 0 ? (float)M_SQRT2 : 1.0f);
+                    if(d < dist[ni + nj * s.N]){
+                        dist[ni + nj * s.N] = d;
+                        open.push(std::make_pair(d, ni + nj * s.N));
+                    }
+                }
+            }
+        }
+        return FLT_MAX;
+    }
+
+    bool isFree(const scenario_t& s, int i, int j){
+        return s.cells[i + j * s.N] == FREE;
+    }
+
+    /* start and goal at least half the grid apart and connected, in a
+     * bug trap the start is inside the cup and the goal behind it
+    */
+    void genQueries(scenario_t& s, ScenarioRandomClass& rng, int trapI0, int trapJ0, int trapI1,
+    int trapJ1){
+        for(int attempt = 0; attempt < 1000 && s.queries.size() < numQueries; attempt++){
+            scenarioQuery_t query;
+            if(s.type == SCENARIO_BUGTRAP){
+                query.start = std::make_pair(rng.uniform(trapI0, trapI1), rng.uniform(trapJ0, trapJ1));
+                query.goal = std::make_pair(rng.uniform(s.N * 3/4, s.N - s.N/20),
+                                            rng.uniform(s.N/10, s.N - s.N/10));
+            }
+            else{
+                query.start = std::make_pair(rng.uniform(0, s.N - 1), rng.uniform(0, s.N - 1));
+                query.goal = std::make_pair(rng.uniform(0, s.N - 1), rng.uniform(0, s.N - 1));
+                float di = query.goal.first - query.start.first;
+                float dj = query.goal.second - query.start.second;
+                if(sqrt(di * di + dj * dj) < s.N/2)
+                    continue;
+            }
+            if(!isFree(s, query.start.first, query.start.second) ||
+            !isFree(s, query.goal.first, query.goal.second))
+                continue;
+            query.gridOptimal = getGridOptimal(s, query.start, query.goal);
+            if(query.gridOptimal == FLT_MAX)
+                continue;
+            s.queries.push_back(query);
+        }
+    }
+
+    bool parseType(const std::string& name, scenarioType& type){
+        for(int k = 0; k < NUM_SCENARIO_TYPES; k++){
+            if(name == typeNames[k]){
+                type = (scenarioType)k;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /* <name>.tune, a missing file is not an error
+    */
+    bool readTunedConfig(const std::string& dir, scenario_t& s){
+        s.tuned = false;
+        std::ifstream file(dir + "/" + s.name + ".tune");
+        if(!file)
+            return true;
+        std::string tag, planner, sampler;
+        int version;
+        plannerConfig_t config = {RRT, 0, 0, 1, UNIFORM_SAMPLER};
+        double latency;
+        if(!(file>>tag>>version) || tag != "tune" || version != corpusVersion ||
+           !(file>>tag>>planner) || tag != "planner" || (planner != "rrt" && planner != "rrt*") ||
+           !(file>>tag>>sampler) || tag != "sampler" || (sampler != "uniform" && sampler != "goal") ||
+           !(file>>tag>>config.step) || tag != "step" ||
+           !(file>>tag>>config.neighborhood) || tag != "neighborhood" ||
+           !(file>>tag>>latency) || tag != "latency_ms"){
+            std::cout<<"[ERROR] Could not read "<<s.name<<".tune, tune the map again"<<std::endl;
+            return false;
+        }
+        config.planner = planner == "rrt" ? RRT : RRT_STAR;
+        config.sampler = sampler == "uniform" ? UNIFORM_SAMPLER : GOAL_BIASED_SAMPLER;
+        s.tuned = true;
+        s.tunedConfig = config;
+        s.tunedLatency = latency/1000.0;
+        return true;
+    }
+}
+
+const char* getScenarioTypeName(scenarioType type){
+    return typeNames[type];
+}
+
+scenario_t generateScenario(scenarioType type, int N, unsigned int seed){
+    scenario_t s;
+    s.name = std::string(typeNames[type]) + "_" + std::to_string(N) + "_" + std::to_string(seed);
+    s.type = type;
+    s.N = N;
+    s.seed = seed;
+    s.cells.assign(N * N, FREE);
+    s.tuned = false;
+
+    ScenarioRandomClass rng(seed * NUM_SCENARIO_TYPES + type);
+    int trapI0 = 0, trapJ0 = 0, trapI1 = 0, trapJ1 = 0;
+    if(type == SCENARIO_CLUTTER)
+        genClutter(s, rng);
+    else if(type == SCENARIO_MAZE)
+        genMaze(s, rng);
+    else if(type == SCENARIO_NARROW)
+        genNarrow(s, rng);
+    else if(type == SCENARIO_BUGTRAP)
+        genBugTrap(s, rng, trapI0, trapJ0, trapI1, trapJ1);
+    addBorder(s);
+    genQueries(s, rng, trapI0, trapJ0, trapI1, trapJ1);
+    return s;
+}
+
+std::vector<scenario_t> generateCorpus(void){
+    std::vector<scenario_t> corpus;
+    for(int t = 0; t < NUM_SCENARIO_TYPES; t++){
+        for(int n = 0; n < sizeof(corpusSizes)/sizeof(int); n++){
+            for(int k = 0; k < sizeof(corpusSeeds)/sizeof(unsigned int); k++)
+                corpus.push_back(generateScenario((scenarioType)t, corpusSizes[n], corpusSeeds[k]));
+        }
+    }
+    return corpus;
+}
+
+bool writeCorpus(const std::string& dir, const std::vector<scenario_t>& corpus){
+    std::ofstream index(dir + "/corpus.txt");
+    if(!index){
+        std::cout<<"[ERROR] Could not open "<<dir<<"/corpus.txt"<<std::endl;
+        return false;
+    }
+    index<<"corpus "<<corpusVersion<<"\n";
+    for(int k = 0; k < corpus.size(); k++){
+        const scenario_t& s = corpus[k];
+        index<<s.name<<" "<<typeNames[s.type]<<" "<<s.N<<" "<<s.seed<<"\n";
+
+        std::ofstream map(dir + "/" + s.name + ".map");
+        map<<"type octile\nheight "<<s.N<<"\nwidth "<<s.N<<"\nmap\n";
+        std::string row(s.N, '.');
+        for(int j = 0; j < s.N; j++){
+            for(int i = 0; i < s.N; i++)
+                row[i] = s.cells[i + j * s.N] == OBSTACLE ? '@' : '.';
+            map<<row<<"\n";
+        }
+        std::ofstream scen(dir + "/" + s.name + ".scen");
+        scen<<"version 1\n"<<std::fixed<<std::setprecision(3);
+        for(int q = 0; q < s.queries.size(); q++){
+            const scenarioQuery_t& query = s.queries[q];
+            scen<<q<<"\t"<<s.name<<".map\t"<<s.N<<"\t"<<s.N<<"\t"<<query.start.first<<"\t"
+                <<query.start.second<<"\t"<<query.goal.first<<"\t"<<query.goal.second<<"\t"
+                <<query.gridOptimal<<"\n";
+        }
+        if(!map || !scen){
+            std::cout<<"[ERROR] Could not write scenario "<<s.name<<std::endl;
+            return false;
+        }
+    }
+    return index.good();
+}
+
+bool readCorpus(const std::string& dir, std::vector<scenario_t>& corpus){
+    std::ifstream index(dir + "/corpus.txt");
+    std::string tag;
+    int version;
+    if(!(index>>tag>>version) || tag != "corpus"){
+        std::cout<<"[ERROR] "<<dir<<"/corpus.txt is not a scenario corpus"<<std::endl;
+        return false;
+    }
+    if(version != corpusVersion){
+        std::cout<<"[ERROR] Corpus version "<<version<<", expected "<<corpusVersion
+                 <<", generate it again"<<std::endl;
+        return false;
+    }
+    corpus.clear();
+    scenario_t s;
+    std::string typeName;
+    while(index>>s.name>>typeName>>s.N>>s.seed){
+        if(!parseType(typeName, s.type)){
+            std::cout<<"[ERROR] Unknown scenario type "<<typeName<<std::endl;
+            return false;
+        }
+        std::ifstream map(dir + "/" + s.name + ".map");
+        std::string line;
+        for(int k = 0; k < 4; k++)
+            std::getline(map, line);
+        s.cells.assign(s.N * s.N, FREE);
+        for(int j = 0; j < s.N; j++){
+            if(!std::getline(map, line) || line.size() < s.N){
+                std::cout<<"[ERROR] Could not read "<<s.name<<".map"<<std::endl;
+                return false;
+            }
+            for(int i = 0; i < s.N; i++)
+                s.cells[i + j * s.N] = line[i] == '.' ? FREE : OBSTACLE;
+        }
+        std::ifstream scen(dir + "/" + s.name + ".scen");
+        std::getline(scen, line);
+        s.queries.clear();
+        while(std::getline(scen, line)){
+            std::istringstream fields(line);
+            std::string mapName;
+            int bucket, width, height;
+            scenarioQuery_t query;
+            if(fields>>bucket>>mapName>>width>>height>>query.start.first>>query.start.second
+                     >>query.goal.first>>query.goal.second>>query.gridOptimal)
+                s.queries.push_back(query);
+        }
+        if(!readTunedConfig(dir, s))
+            return false;
+        corpus.push_back(s);
+    }
+    return true;
+}
+
+bool writeTunedConfig(const std::string& dir, const scenario_t& scenario){
+    std::ofstream file(dir + "/" + scenario.name + ".tune");
+    const plannerConfig_t& config = scenario.tunedConfig;
+    file<<"tune "<<corpusVersion<<"\n"
+        <<"planner "<<(config.planner == RRT ? "rrt" : "rrt*")<<"\n"
+        <<"sampler "<<(config.sampler == UNIFORM_SAMPLER ? "uniform" : "goal")<<"\n"
+        <<"step "<<config.step<<"\n"
+        <<"neighborhood "<<config.neighborhood<<"\n"
+        <<"latency_ms "<<scenario.tunedLatency * 1000.0<<"\n";
+    if(!file){
+        std::cout<<"[ERROR] Could not write "<<dir<<"/"<<scenario.name<<".tune"<<std::endl;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,163 @@
+#include "../../Include/Scenario/ScenarioRunner.h"
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <algorithm>
+
+namespace{
+    /* nearest rank percentile of sorted values
+    */
+    double getPercentile(const std::vector<double>& sorted, double p){
+        if(sorted.size() == 0)
+            return 0;
+        int rank = (int)ceil(p/100.0 * sorted.size());
+        return sorted[std::max(rank, 1) - 1];
+    }
+}
+
+queryResult_t runQuery(const scenario_t& scenario, const scenarioQuery_t& query,
+const plannerConfig_t& config, int maxIterations, ArenaClass& arena,
+std::vector<std::pair<int, int>>& path){
+    queryResult_t result = {false, 0, 0, 0, 0};
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    {
+        RandomTreeClass planner(config.step, config.neighborhood, scenario.N,
+        scenario.cells.data(), config.planner, config.seed, &arena);
+        planner.setSampler(config.sampler);
+        result.pathFound = planner.solve(query.start, query.goal, maxIterations, NULL, path);
+        result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+        startTime).count();
+        result.memory = arena.getUsedBytes();
+    }
+    arena.reset();
+    if(result.pathFound){
+        result.cost = getPathCost(path);
+        result.costRatio = result.cost/query.gridOptimal;
+    }
+    return result;
+}
+
+std::string getConfigName(const plannerConfig_t& config){
+    return std::string(config.planner == RRT ? "RRT" : "RRT*") + " step " +
+           std::to_string(config.step) + " nbhd " + std::to_string(config.neighborhood) +
+           (config.sampler == GOAL_BIASED_SAMPLER ? " goal" : "");
+}
+
+std::vector<plannerConfig_t> getDefaultConfigs(void){
+    return {{RRT, 10, 50, 1, UNIFORM_SAMPLER}, {RRT, 20, 100, 1, UNIFORM_SAMPLER},
+            {RRT_STAR, 10, 50, 1, UNIFORM_SAMPLER}, {RRT_STAR, 20, 100, 1, UNIFORM_SAMPLER}};
+}
+
+ScenarioRunnerClass::ScenarioRunnerClass(const std::vector<scenario_t>& _corpus,
+std::vector<plannerConfig_t> _configs, int _maxIterations, int _repeats): corpus(_corpus){
+    configs = _configs;
+    maxIterations = _maxIterations;
+    repeats = _repeats;
+}
+
+/* the configuration after the last one is the tuned configuration of
+ * the scenario, if it has one
+*/
+int ScenarioRunnerClass::getNumConfigs(const scenario_t& scenario){
+    return configs.size() + (scenario.tuned ? 1 : 0);
+}
+
+const plannerConfig_t& ScenarioRunnerClass::getConfig(const scenario_t& scenario, int configIdx){
+    return configIdx < configs.size() ? configs[configIdx] : scenario.tunedConfig;
+}
+
+std::string ScenarioRunnerClass::getRunConfigName(const scenario_t& scenario, int configIdx){
+    if(configIdx < configs.size())
+        return getConfigName(configs[configIdx]);
+    return "tuned " + getConfigName(scenario.tunedConfig);
+}
+
+void ScenarioRunnerClass::run(const std::string& filter){
+    runs.clear();
+    ArenaClass arena(1 << 20);
+    std::vector<std::pair<int, int>> path;
+    for(int s = 0; s < corpus.size(); s++){
+        const scenario_t& scenario = corpus[s];
+        if(scenario.name.find(filter) == std::string::npos)
+            continue;
+        for(int c = 0; c < getNumConfigs(scenario); c++){
+            const plannerConfig_t& config = getConfig(scenario, c);
+            for(int q = 0; q < scenario.queries.size(); q++){
+                for(int r = 0; r < repeats; r++){
+                    scenarioRun_t run = {s, q, c, r, {false, 0, 0, 0, 0}};
+                    plannerConfig_t seeded = config;
+                    seeded.seed = config.seed + r;
+                    run.result = runQuery(scenario, scenario.queries[q], seeded, maxIterations,
+                    arena, path);
+                    runs.push_back(run);
+                }
+            }
+        }
+        std::cout<<"Ran "<<scenario.name<<std::endl;
+    }
+}
+
+void ScenarioRunnerClass::printSummary(void){
+    printf("%-26s %-8s %5s %7s %10s %10s %10s %8s %10s\n", "Config", "Type", "N", "Solved",
+    "p50 ms", "p90 ms", "p99 ms", "Cost", "Memory KB");
+    /* the tuned configurations of all maps are summed up in one row
+    */
+    for(int c = 0; c <= configs.size(); c++){
+        for(int t = 0; t < NUM_SCENARIO_TYPES; t++){
+            /* grid sizes in the order they show up in the corpus
+            */
+            std::vector<int> sizes;
+            for(int k = 0; k < runs.size(); k++){
+                const scenario_t& scenario = corpus[runs[k].scenarioIdx];
+                if(runs[k].configIdx == c && scenario.type == t &&
+                   std::find(sizes.begin(), sizes.end(), scenario.N) == sizes.end())
+                    sizes.push_back(scenario.N);
+            }
+            for(int n = 0; n < sizes.size(); n++){
+                std::vector<double> times;
+                int numRuns = 0;
+                double costRatio = 0, memory = 0;
+                for(int k = 0; k < runs.size(); k++){
+                    const scenario_t& scenario = corpus[runs[k].scenarioIdx];
+                    if(runs[k].configIdx != c || scenario.type != t || scenario.N != sizes[n])
+                        continue;
+                    numRuns++;
+                    memory += runs[k].result.memory;
+                    if(runs[k].result.pathFound){
+                        times.push_back(runs[k].result.time * 1000.0);
+                        costRatio += runs[k].result.costRatio;
+                    }
+                }
+                std::sort(times.begin(), times.end());
+                char solved[16];
+                snprintf(solved, sizeof(solved), "%d/%d", (int)times.size(), numRuns);
+                printf("%-26s %-8s %5d %7s %10.2f %10.2f %10.2f %8.3f %10.1f\n",
+                c < configs.size() ? getConfigName(configs[c]).c_str() : "tuned",
+                getScenarioTypeName((scenarioType)t), sizes[n],
+                solved, getPercentile(times, 50), getPercentile(times, 90), getPercentile(times, 99),
+                times.size() == 0 ? 0 : costRatio/times.size(), memory/numRuns/1024.0);
+            }
+        }
+    }
+}
+
+bool ScenarioRunnerClass::writeCSV(const std::string& fileName){
+    std::ofstream file(fileName);
+    if(!file){
+        std::cout<<"[ERROR] Could not open "<<fileName<<std::endl;
+        return false;
+    }
+    file<<"corpus_version,scenario,type,N,query,config,repeat,path_found,time_ms,cost,cost_ratio,"
+          "memory_bytes\n";
+    for(int k = 0; k < runs.size(); k++){
+        const scenarioRun_t& run = runs[k];
+        const scenario_t& scenario = corpus[run.scenarioIdx];
+        file<<corpusVersion<<","<<scenario.name<<","<<getScenarioTypeName(scenario.type)<<","
+            <<scenario.N<<","<<run.queryIdx<<","<<getRunConfigName(scenario, run.configIdx)<<","
+            <<run.repeat<<","<<run.result.pathFound<<","<<run.result.time * 1000.0<<","<<run.result.cost<<","
+            <<run.result.costRatio<<","<<run.result.memory<<"\n";
+    }
+    return file.good();
+}
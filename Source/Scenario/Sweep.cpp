@@ -0,0 +1,222 @@
+#include "../../Include/Scenario/Sweep.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <algorithm>
+
+namespace{
+    /* a comma separated list of positive integers and start:end:increment
+     * ranges
+    */
+    bool parseValues(const std::string& text, std::vector<int>& values){
+        values.clear();
+        std::istringstream list(text);
+        std::string item;
+        while(std::getline(list, item, ',')){
+            /* start[:end[:increment]]
+            */
+            std::replace(item.begin(), item.end(), ':', ' ');
+            std::istringstream fields(item);
+            int start, end, inc = 1;
+            if(!(fields>>start))
+                return false;
+            end = start;
+            if(!fields.eof() && !(fields>>end))
+                return false;
+            if(!fields.eof() && !(fields>>inc))
+                return false;
+            if(!fields.eof())
+                return false;
+            if(start <= 0 || inc <= 0)
+                return false;
+            for(int v = start; v <= end; v += inc)
+                values.push_back(v);
+        }
+        return values.size() > 0;
+    }
+
+    bool parseNames(const std::string& text, std::vector<std::string>& names){
+        names.clear();
+        std::istringstream list(text);
+        std::string item;
+        while(std::getline(list, item, ','))
+            names.push_back(item);
+        return names.size() > 0;
+    }
+}
+
+sweepSpec_t getDefaultSweepSpec(void){
+    sweepSpec_t spec;
+    for(int t = 0; t < NUM_SCENARIO_TYPES; t++)
+        spec.types.push_back((scenarioType)t);
+    spec.sizes = {200};
+    spec.steps = {5, 10, 20, 40};
+    spec.neighborhoods = {25, 50, 100, 200};
+    spec.planners = {RRT, RRT_STAR};
+    spec.samplers = {UNIFORM_SAMPLER, GOAL_BIASED_SAMPLER};
+    spec.numMaps = 1;
+    spec.numSeeds = 3;
+    spec.maxIterations = 5000;
+    spec.numThreads = std::thread::hardware_concurrency();
+    if(spec.numThreads == 0)
+        spec.numThreads = 1;
+    return spec;
+}
+
+bool parseSweepArg(const std::string& arg, sweepSpec_t& spec){
+    size_t eq = arg.find('=');
+    if(eq == std::string::npos){
+        std::cout<<"[ERROR] Expected key=value, got "<<arg<<std::endl;
+        return false;
+    }
+    std::string key = arg.substr(0, eq);
+    std::string value = arg.substr(eq + 1);
+    std::vector<int> values;
+    std::vector<std::string> names;
+    bool valid = true;
+
+    if(key == "type"){
+        spec.types.clear();
+        valid = parseNames(value, names);
+        for(int k = 0; k < names.size() && valid; k++){
+            int t = 0;
+            while(t < NUM_SCENARIO_TYPES && names[k] != getScenarioTypeName((scenarioType)t))
+                t++;
+            valid = t < NUM_SCENARIO_TYPES;
+            spec.types.push_back((scenarioType)t);
+        }
+    }
+    else if(key == "planner"){
+        spec.planners.clear();
+        valid = parseNames(value, names);
+        for(int k = 0; k < names.size() && valid; k++){
+            valid = names[k] == "rrt" || names[k] == "rrt*";
+            spec.planners.push_back(names[k] == "rrt" ? RRT : RRT_STAR);
+        }
+    }
+    else if(key == "sampler"){
+        spec.samplers.clear();
+        valid = parseNames(value, names);
+        for(int k = 0; k < names.size() && valid; k++){
+            valid = names[k] == "uniform" || names[k] == "goal";
+            spec.samplers.push_back(names[k] == "uniform" ? UNIFORM_SAMPLER : GOAL_BIASED_SAMPLER);
+        }
+    }
+    else if(key == "N")
+        valid = parseValues(value, spec.sizes);
+    else if(key == "step")
+        valid = parseValues(value, spec.steps);
+    else if(key == "nbhd")
+        valid = parseValues(value, spec.neighborhoods);
+    else if(key == "maps" || key == "seeds" || key == "maxIter" || key == "threads"){
+        valid = parseValues(value, values) && values.size() == 1 && values[0] > 0;
+        if(valid){
+            int& field = key == "maps" ? spec.numMaps : key == "seeds" ? spec.numSeeds :
+                         key == "maxIter" ? spec.maxIterations : spec.numThreads;
+            field = values[0];
+        }
+    }
+    else{
+        std::cout<<"[ERROR] Unknown sweep parameter "<<key<<std::endl;
+        return false;
+    }
+    if(!valid)
+        std::cout<<"[ERROR] Invalid value for "<<key<<": "<<value<<std::endl;
+    return valid;
+}
+
+SweepClass::SweepClass(const sweepSpec_t& _spec){
+    spec = _spec;
+    nextRun = 0;
+}
+
+void SweepClass::run(void){
+    scenarios.clear();
+    for(int t = 0; t < spec.types.size(); t++){
+        for(int n = 0; n < spec.sizes.size(); n++){
+            for(int m = 1; m <= spec.numMaps; m++)
+                scenarios.push_back(generateScenario(spec.types[t], spec.sizes[n], m));
+        }
+    }
+    /* the neighborhood is only used by RRT*, RRT runs once per step with
+     * neighborhood 0
+    */
+    std::vector<plannerConfig_t> configs;
+    for(int p = 0; p < spec.planners.size(); p++){
+        for(int s = 0; s < spec.samplers.size(); s++){
+            for(int k = 0; k < spec.steps.size(); k++){
+                if(spec.planners[p] == RRT){
+                    configs.push_back({RRT, spec.steps[k], 0, 0, spec.samplers[s]});
+                    continue;
+                }
+                for(int h = 0; h < spec.neighborhoods.size(); h++)
+                    configs.push_back({RRT_STAR, spec.steps[k], spec.neighborhoods[h], 0,
+                    spec.samplers[s]});
+            }
+        }
+    }
+
+    runs.clear();
+    for(int s = 0; s < scenarios.size(); s++){
+        for(int q = 0; q < scenarios[s].queries.size(); q++){
+            for(int c = 0; c < configs.size(); c++){
+                for(int r = 1; r <= spec.numSeeds; r++){
+                    sweepRun_t run = {s, q, configs[c], {false, 0, 0, 0, 0}};
+                    run.config.seed = r;
+                    runs.push_back(run);
+                }
+            }
+        }
+    }
+    std::cout<<"Sweep: "<<runs.size()<<" runs ("<<scenarios.size()<<" maps, "<<configs.size()
+             <<" configs, "<<spec.numSeeds<<" seeds) on "<<spec.numThreads<<" threads"<<std::endl;
+
+    std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+    nextRun = 0;
+    std::vector<std::thread> workers;
+    for(int k = 0; k < spec.numThreads; k++)
+        workers.push_back(std::thread(&SweepClass::worker, this));
+    for(int k = 0; k < workers.size(); k++)
+        workers[k].join();
+    std::cout<<"Sweep done in "<<std::chrono::duration<double>(std::chrono::steady_clock::now() -
+             startTime).count()<<" s"<<std::endl;
+}
+
+/* each run writes only its own entry of runs
+*/
+void SweepClass::worker(void){
+    ArenaClass arena(1 << 20);
+    std::vector<std::pair<int, int>> path;
+    while(1){
+        int k = nextRun.fetch_add(1);
+        if(k >= runs.size())
+            break;
+        sweepRun_t& run = runs[k];
+        const scenario_t& scenario = scenarios[run.scenarioIdx];
+        run.result = runQuery(scenario, scenario.queries[run.queryIdx], run.config, spec.maxIterations,
+        arena, path);
+    }
+}
+
+bool SweepClass::writeCSV(const std::string& fileName){
+    std::ofstream file(fileName);
+    if(!file){
+        std::cout<<"[ERROR] Could not open "<<fileName<<std::endl;
+        return false;
+    }
+    file<<"corpus_version,type,N,map_seed,query,planner,sampler,step,neighborhood,seed,"
+          "path_found,time_ms,cost,cost_ratio,memory_bytes\n";
+    for(int k = 0; k < runs.size(); k++){
+        const sweepRun_t& run = runs[k];
+        const scenario_t& scenario = scenarios[run.scenarioIdx];
+        file<<corpusVersion<<","<<getScenarioTypeName(scenario.type)<<","<<scenario.N<<","
+            <<scenario.seed<<","<<run.queryIdx<<","<<(run.config.planner == RRT ? "rrt" : "rrt*")
+            <<","<<(run.config.sampler == UNIFORM_SAMPLER ? "uniform" : "goal")<<","
+            <<run.config.step<<","<<run.config.neighborhood<<","<<run.config.seed<<","
+            <<run.result.pathFound<<","<<run.result.time * 1000.0<<","<<run.result.cost<<","
+            <<run.result.costRatio<<","<<run.result.memory<<"\n";
+    }
+    return file.good();
+}
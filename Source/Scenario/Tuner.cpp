@@ -0,0 +1,93 @@
+#include "../../Include/Scenario/Tuner.h"
+#include "../../Include/Scenario/ScenarioRunner.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cstdio>
+
+namespace{
+    /* step candidates, the neighborhood of RRT* is tried at a few
+     * multiples of the step
+    */
+    const int tunerSteps[] = {2, 3, 5, 8, 12, 20, 32, 50};
+    const float tunerNeighborhoods[] = {1.5, 3.0, 5.0, 8.0};
+}
+
+TunerClass::TunerClass(const scenario_t& _scenario, plannerType _planner, samplerType _sampler,
+double _latencyTarget, int _initialTrials): scenario(_scenario){
+    planner = _planner;
+    sampler = _sampler;
+    latencyTarget = _latencyTarget;
+    initialTrials = _initialTrials > 0 ? _initialTrials : scenario.queries.size();
+}
+
+void TunerClass::initCandidates(void){
+    candidates.clear();
+    for(int k = 0; k < sizeof(tunerSteps)/sizeof(int); k++){
+        /* a step this long skips over most of the map
+        */
+        if(tunerSteps[k] > scenario.N/4)
+            break;
+        tunerCandidate_t candidate = {{planner, tunerSteps[k], 0, 1, sampler}, 0, 0, 0};
+        if(planner == RRT){
+            candidates.push_back(candidate);
+            continue;
+        }
+        for(int h = 0; h < sizeof(tunerNeighborhoods)/sizeof(float); h++){
+            candidate.config.neighborhood = tunerSteps[k] * tunerNeighborhoods[h] + 0.5;
+            candidates.push_back(candidate);
+        }
+    }
+}
+
+/* trial k plans query k % numQueries with seed k / numQueries + 1, so
+ * the trials of a round are the trials of the round before plus new ones
+ * and every candidate sees the same trials
+*/
+void TunerClass::runTrials(tunerCandidate_t& candidate, int numTrials){
+    for(int k = candidate.numTrials; k < numTrials; k++){
+        const scenarioQuery_t& query = scenario.queries[k % scenario.queries.size()];
+        plannerConfig_t config = candidate.config;
+        config.seed = k / scenario.queries.size() + 1;
+        PortfolioClass portfolio(scenario.cells.data(), scenario.N, {config});
+        portfolioResult_t result = portfolio.run(query.start, query.goal, FIRST_SOLUTION,
+        latencyTarget, INT_MAX);
+        if(result.pathFound && result.timeToSolution <= latencyTarget){
+            candidate.numSolved++;
+            candidate.costRatioSum += result.cost/query.gridOptimal;
+        }
+    }
+    candidate.numTrials = std::max(candidate.numTrials, numTrials);
+}
+
+bool TunerClass::isBetter(const tunerCandidate_t& a, const tunerCandidate_t& b){
+    double solvedA = (double)a.numSolved/a.numTrials;
+    double solvedB = (double)b.numSolved/b.numTrials;
+    if(solvedA != solvedB)
+        return solvedA > solvedB;
+    if(a.numSolved == 0)
+        return false;
+    return a.costRatioSum/a.numSolved < b.costRatioSum/b.numSolved;
+}
+
+plannerConfig_t TunerClass::tune(void){
+    initCandidates();
+    int numTrials = initialTrials;
+    for(int round = 0; candidates.size() > 1; round++){
+        for(int k = 0; k < candidates.size(); k++)
+            runTrials(candidates[k], numTrials);
+        std::stable_sort(candidates.begin(), candidates.end(), isBetter);
+
+        const tunerCandidate_t& best = candidates[0];
+        printf("Round %d: %2d candidates, %3d trials, best %-22s solved %5.1f%% cost %.3f\n",
+        round, (int)candidates.size(), numTrials, getConfigName(best.config).c_str(),
+        100.0 * best.numSolved/best.numTrials, best.numSolved == 0 ? 0 :
+        best.costRatioSum/best.numSolved);
+
+        candidates.resize((candidates.size() + 1)/2);
+        numTrials *= 2;
+    }
+    plannerConfig_t config = candidates[0].config;
+    config.seed = 1;
+    return config;
+}
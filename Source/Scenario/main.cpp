@@ -0,0 +1,72 @@
+#include "../../Include/Scenario/Scenario.h"
+#include "../../Include/Scenario/ScenarioRunner.h"
+#include "../../Include/Scenario/Sweep.h"
+#include "../../Include/Scenario/Tuner.h"
+#include <iostream>
+#include <string>
+#include <stdlib.h>
+
+/* usage: Scenario.exe generate <dir>
+ *        Scenario.exe run <dir> [max iterations] [repeats] [name filter]
+ *        Scenario.exe sweep <csv file> [key=value ...], see Sweep.h
+ *        Scenario.exe tune <dir> <scenario name> <latency ms> [rrt|rrt*] [uniform|goal]
+*/
+int main(int argc, char **argv){
+    std::string mode = argc > 1 ? argv[1] : "";
+    if(argc < 3 || (mode != "generate" && mode != "run" && mode != "sweep" &&
+       mode != "tune")){
+        std::cout<<"usage: "<<argv[0]<<" generate <dir>"<<std::endl;
+        std::cout<<"       "<<argv[0]<<" run <dir> [max iterations] [repeats] [name filter]"
+                 <<std::endl;
+        std::cout<<"       "<<argv[0]<<" sweep <csv file> [key=value ...]"<<std::endl;
+        std::cout<<"       "<<argv[0]<<" tune <dir> <scenario name> <latency ms> [rrt|rrt*] "
+                   "[uniform|goal]"<<std::endl;
+        return 1;
+    }
+    std::string dir = argv[2];
+    if(mode == "generate")
+        return writeCorpus(dir, generateCorpus()) ? 0 : 1;
+
+    if(mode == "sweep"){
+        sweepSpec_t spec = getDefaultSweepSpec();
+        for(int k = 3; k < argc; k++){
+            if(!parseSweepArg(argv[k], spec))
+                return 1;
+        }
+        SweepClass sweep(spec);
+        sweep.run();
+        return sweep.writeCSV(argv[2]) ? 0 : 1;
+    }
+
+    std::vector<scenario_t> corpus;
+    if(!readCorpus(dir, corpus))
+        return 1;
+
+    if(mode == "tune"){
+        int s = 0;
+        while(s < corpus.size() && (argc < 4 || corpus[s].name != argv[3]))
+            s++;
+        double latency = argc > 4 ? atof(argv[4])/1000.0 : 0;
+        if(s == corpus.size() || corpus[s].queries.size() == 0 || latency <= 0){
+            std::cout<<"[ERROR] Expected a scenario of the corpus and a latency in ms"<<std::endl;
+            return 1;
+        }
+        plannerType planner = argc > 5 && std::string(argv[5]) == "rrt" ? RRT : RRT_STAR;
+        samplerType sampler = argc > 6 && std::string(argv[6]) == "goal" ? GOAL_BIASED_SAMPLER :
+                              UNIFORM_SAMPLER;
+        TunerClass tuner(corpus[s], planner, sampler, latency);
+        corpus[s].tunedConfig = tuner.tune();
+        corpus[s].tunedLatency = latency;
+        corpus[s].tuned = true;
+        std::cout<<corpus[s].name<<": "<<getConfigName(corpus[s].tunedConfig)<<std::endl;
+        return writeTunedConfig(dir, corpus[s]) ? 0 : 1;
+    }
+    int maxIterations = argc > 3 ? atoi(argv[3]) : 5000;
+    int repeats = argc > 4 ? atoi(argv[4]) : 3;
+    std::string filter = argc > 5 ? argv[5] : "";
+
+    ScenarioRunnerClass runner(corpus, getDefaultConfigs(), maxIterations, repeats);
+    runner.run(filter);
+    runner.printSummary();
+    return runner.writeCSV(dir + "/results.csv") ? 0 : 1;
+}
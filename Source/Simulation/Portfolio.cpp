@@ -0,0 +1,92 @@
+#include "../../Include/Simulation/Portfolio.h"
+#include <thread>
+#include <climits>
+
+PortfolioClass::PortfolioClass(const int *_cellMap, int _N, std::vector<plannerConfig_t> _configs){
+    cellMap = _cellMap;
+    N = _N;
+    configs = _configs;
+}
+
+PortfolioClass::~PortfolioClass(void){
+}
+
+/* runs on its own thread, every planner owns its tree and only shares
+ * the read-only grid with the others
+*/
+void PortfolioClass::runPlanner(int configIdx){
+    plannerConfig_t config = configs[configIdx];
+    RandomTreeClass planner(config.step, config.neighborhood, N, cellMap, config.planner, 
+    config.seed);
+    planner.setSampler(config.sampler);
+
+    std::vector<std::pair<int, int>> path;
+    bool pathFound = planner.solve(startCell, endCell, maxIterations, &cancel, path);
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - 
+    startTime).count();
+
+    std::lock_guard<std::mutex> lock(mtx);
+    numDone++;
+    if(pathFound && !decided){
+        float cost = getPathCost(path);
+        if(!result.pathFound || (mode == BEST_SOLUTION && cost < result.cost)){
+            result.pathFound = true;
+            result.configIdx = configIdx;
+            result.cost = cost;
+            result.timeToSolution = elapsed;
+            result.path = path;
+        }
+        /* the rest of the planners are not needed anymore
+        */
+        if(mode == FIRST_SOLUTION)
+            cancel.store(true, std::memory_order_relaxed);
+    }
+    cv.notify_all();
+}
+
+/* run all planners from start to end. Returns once the result is decided,
+ * that is when the first path is found (FIRST_SOLUTION), all planners are
+ * done or the deadline in seconds has passed. A deadline <= 0 means no
+ * deadline
+*/
+portfolioResult_t PortfolioClass::run(std::pair<int, int> start, std::pair<int, int> end,
+portfolioMode _mode, double deadline, int _maxIterations){
+    startCell = start;
+    endCell = end;
+    mode = _mode;
+    maxIterations = _maxIterations;
+
+    result.pathFound = false;
+    result.configIdx = -1;
+    result.cost = INT_MAX;
+    result.timeToSolution = 0;
+    result.path.clear();
+    numDone = 0;
+    decided = false;
+    cancel.store(false);
+    startTime = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for(int k = 0; k < configs.size(); k++)
+        workers.push_back(std::thread(&PortfolioClass::runPlanner, this, k));
+
+    {
+        std::unique_lock<std::mutex> lock(mtx);
+        auto isDecided = [this]{
+            return numDone == configs.size() || (mode == FIRST_SOLUTION && result.pathFound);
+        };
+        if(deadline > 0)
+            cv.wait_until(lock, startTime + std::chrono::duration_cast<std::chrono::steady_clock::
+            duration>(std::chrono::duration<double>(deadline)), isDecided);
+        else
+            cv.wait(lock, isDecided);
+        /* planners that finish after this point are ignored
+        */
+        decided = true;
+        cancel.store(true, std::memory_order_relaxed);
+    }
+
+    for(int k = 0; k < workers.size(); k++)
+        workers[k].join();
+    return result;
+}
@@ -0,0 +1,136 @@
+#include "../../Include/Simulation/QueryPool.h"
+#include "../../Include/Utils/Arena.h"
+#include <chrono>
+
+QueryPoolClass::QueryPoolClass(const int *_cellMap, int _N, plannerConfig_t _config, 
+int _maxIterations, int _numThreads){
+    cellMap = _cellMap;
+    N = _N;
+    config = _config;
+    maxIterations = _maxIterations;
+
+    numThreads = _numThreads > 0 ? _numThreads : std::thread::hardware_concurrency();
+    if(numThreads == 0)
+        numThreads = 1;
+
+    queues.resize(numThreads);
+    queueMtx = new std::mutex[numThreads];
+    numPending = 0;
+    nextQueue = 0;
+    stop = false;
+    numOutstanding = 0;
+
+    for(int k = 0; k < numThreads; k++)
+        workers.push_back(std::thread(&QueryPoolClass::worker, this, k));
+}
+
+QueryPoolClass::~QueryPoolClass(void){
+    {
+        std::lock_guard<std::mutex> lock(workMtx);
+        stop = true;
+    }
+    workCv.notify_all();
+    for(int k = 0; k < workers.size(); k++)
+        workers[k].join();
+    delete[] queueMtx;
+}
+
+/* spread the queries round robin over the worker queues, stealing
+ * evens out the load if the queries take different times
+*/
+void QueryPoolClass::submit(const std::vector<query_t>& queries){
+    for(int k = 0; k < queries.size(); k++){
+        std::lock_guard<std::mutex> lock(queueMtx[nextQueue]);
+        queues[nextQueue].push_back(queries[k]);
+        nextQueue = (nextQueue + 1) % numThreads;
+    }
+    {
+        std::lock_guard<std::mutex> lock(resultMtx);
+        numOutstanding += queries.size();
+    }
+    {
+        std::lock_guard<std::mutex> lock(workMtx);
+        numPending += queries.size();
+    }
+    workCv.notify_all();
+}
+
+/* take from the back of our own queue, if it is empty steal from the
+ * front of the others
+*/
+bool QueryPoolClass::popQuery(int workerIdx, query_t& query){
+    for(int k = 0; k < numThreads; k++){
+        int idx = (workerIdx + k) % numThreads;
+        std::lock_guard<std::mutex> lock(queueMtx[idx]);
+        if(queues[idx].size() == 0)
+            continue;
+
+        if(idx == workerIdx){
+            query = queues[idx].back();
+            queues[idx].pop_back();
+        }
+        else{
+            query = queues[idx].front();
+            queues[idx].pop_front();
+        }
+        numPending--;
+        return true;
+    }
+    return false;
+}
+
+void QueryPoolClass::worker(int workerIdx){
+    ArenaClass arena(1 << 20);
+
+    while(true){
+        query_t query;
+        if(!popQuery(workerIdx, query)){
+            std::unique_lock<std::mutex> lock(workMtx);
+            workCv.wait(lock, [this]{ return stop || numPending > 0; });
+            if(stop && numPending <= 0)
+                return;
+            continue;
+        }
+
+        queryResult_t result;
+        result.id = query.id;
+        std::chrono::steady_clock::time_point startTime = std::chrono::steady_clock::now();
+        {
+            /* seed from the query id, so a query plans the same way no
+             * matter which worker picks it up
+            */
+            RandomTreeClass planner(config.step, config.neighborhood, N, cellMap, config.planner,
+            config.seed + query.id, &arena);
+            planner.setSampler(config.sampler);
+            result.pathFound = planner.solve(query.start, query.end, maxIterations, NULL, 
+            result.path);
+        }
+        /* the planner is gone, the arena can be handed out again
+        */
+        arena.reset();
+        result.time = std::chrono::duration<double>(std::chrono::steady_clock::now() - 
+        startTime).count();
+        result.cost = getPathCost(result.path);
+
+        {
+            std::lock_guard<std::mutex> lock(resultMtx);
+            results.push_back(result);
+        }
+        resultCv.notify_one();
+    }
+}
+
+/* blocks until a result is ready, returns false once all submitted
+ * queries have been handed out
+*/
+bool QueryPoolClass::nextResult(queryResult_t& result){
+    std::unique_lock<std::mutex> lock(resultMtx);
+    resultCv.wait(lock, [this]{ return results.size() > 0 || numOutstanding == 0; });
+    if(results.size() == 0)
+        return false;
+
+    result = results.front();
+    results.pop_front();
+    numOutstanding--;
+    return true;
+}
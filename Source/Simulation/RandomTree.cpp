@@ -1,11 +1,47 @@
 #include "../../Include/Simulation/RandomTree.h"
 #include "../../Include/Simulation/Constants.h"
 #include "../../Include/Utils/Common.h"
+#include "../../Include/Utils/Log.h"
+#include "../../Include/Utils/Stats.h"
+#include "../../Include/Utils/Trace.h"
+#include "../../Include/Utils/Alloc.h"
 #include <iostream>
+#include <thread>
+#include <random>
+#include <algorithm>
+#include <climits>
+#include <cassert>
 
 RandomTreeClass::RandomTreeClass(int _step, int _neighborhood, int _N, int _scale, bool noStroke): 
 GridClass(_N, _scale, noStroke), TreeClass(){
     cellCurr = (int*)calloc(N * N, sizeof(int));
+    cellMap = cellCurr;
+    headless = false;
+    planner = RAPID_RANDOM_TREE_STAR == 1 ? RRT_STAR : RRT;
+    sampler = GOAL_BIASED_SAMPLING == 1 ? GOAL_BIASED_SAMPLER : UNIFORM_SAMPLER;
+
+    std::random_device rd;
+    plannerSeed = rd();
+    randomEngine.seed(plannerSeed);
+    initParams(_step, _neighborhood);
+}
+
+RandomTreeClass::RandomTreeClass(int _step, int _neighborhood, int _N, const int *sharedCells,
+plannerType _planner, unsigned int seed, ArenaClass *arena): GridClass(_N), TreeClass(arena){
+    /* the shared grid is never written to
+    */
+    cellCurr = NULL;
+    cellMap = sharedCells;
+    headless = true;
+    planner = _planner;
+    sampler = UNIFORM_SAMPLER;
+
+    plannerSeed = seed;
+    randomEngine.seed(seed);
+    initParams(_step, _neighborhood);
+}
+
+void RandomTreeClass::initParams(int _step, int _neighborhood){
     step = _step;
     neighborhood = _neighborhood;
     /* will be alive throughout the life of the program
@@ -19,6 +55,7 @@ GridClass(_N, _scale, noStroke), TreeClass(){
     borderWidth = 0.03 * N;
 
     pathFound = false;
+    checkExistingPath = false;
     /* this highlight width is used for START_CELL or NODE
     */
     otherCellHighlightWidth = 0.01 * N;
@@ -38,21 +75,158 @@ GridClass(_N, _scale, noStroke), TreeClass(){
     /* used for node connection alpha
     */
     nodeConnectionAlpha = 0.2;
+    /* tree edges and the final path are drawn as lines over the grid
+    */
+    setLineStyle(blueVal, nodeConnectionAlpha, redVal, pathHighlightAlpha, pathHighlightWidth);
     /* num random obstacles
     */
     numObstacles = 0.02 * N;
+    /* batch mode workers, fall back to a single worker if the number
+     * of cores cannot be detected
+    */
+    numWorkers = std::thread::hardware_concurrency();
+    if(numWorkers == 0)
+        numWorkers = 1;
+    batchGeneration = 0;
+    numBatchWorkersBusy = 0;
+    stopBatch = false;
+    /* the shared tree is only created when the workers are started
+     * for the first time
+    */
+    sharedTree = NULL;
+    stopWorkers = false;
+    numNodesMirrored = 0;
+    /* the snapshot renderer is only created when the first snapshot
+     * is taken
+    */
+    snapshot = NULL;
+    numSteps = 0;
+    /* there is at most one node per cell
+    */
+    neighborhoodNodes.reserve((2 * neighborhood + 1) * (2 * neighborhood + 1));
 }
 
 RandomTreeClass::~RandomTreeClass(void){
+    stopBatchWorkers();
+    stopSharedTreeWorkers();
+    delete sharedTree;
+    delete snapshot;
     free(cellCurr);
 }
 
+void RandomTreeClass::setSampler(samplerType _sampler){
+    sampler = _sampler;
+}
+
+/* headless planning from start to end, grows the tree until the goal
+ * is reached, maxIterations are done or cancel is set. On success the
+ * path from end to start is written to solvedPath
+*/
+bool RandomTreeClass::solve(std::pair<int, int> start, std::pair<int, int> end, int maxIterations,
+const std::atomic<bool> *cancel, std::vector<std::pair<int, int>>& solvedPath){
+    assert(headless);
+    startX = start.first;
+    startY = start.second;
+    endX = end.first;
+    endY = end.second;
+    pathFound = false;
+
+    std::pair<int, int> newNode = start;
+    createNode(start);
+    if(isGoalReached(start))
+        pathFound = true;
+
+    for(int k = 0; k < maxIterations && !pathFound; k++){
+        if(cancel != NULL && cancel->load(std::memory_order_relaxed))
+            break;
+        STATS_COUNT(COUNT_ITERATIONS);
+        ALLOC_SCOPE(allocs);
+#if ALLOC_TRACKING == 1
+        int numBlocks = getNumArenaBlocks();
+#endif
+
+        std::pair<int, int> rNode = getRandomCell();
+        if(planner == RRT)
+            placeNodeRRT(rNode, newNode);
+        else
+            placeNodeRRTStar(rNode, newNode);
+#if ALLOC_TRACKING == 1
+        /* the first iteration sizes the scratch buffers, from then on
+         * the only allocations are new blocks of the tree's arena
+        */
+        assert(k == 0 || allocs.getCount() == getNumArenaBlocks() - numBlocks);
+#endif
+    }
+
+    if(pathFound)
+        getPath(newNode, path);
+#if SNAPSHOT_MODE == 1
+    saveSnapshot(std::string(snapshotPrefix) + "_" + std::to_string(plannerSeed) + ".png");
+#endif
+    if(!pathFound)
+        return false;
+    solvedPath = path;
+    return true;
+}
+
+void RandomTreeClass::setNoGoal(void){
+    assert(headless);
+    endX = -N;
+    endY = -N;
+}
+
+bool RandomTreeClass::growOnce(void){
+    std::pair<int, int> newNode;
+    std::pair<int, int> rNode = getRandomCell();
+    if(planner == RRT)
+        return placeNodeRRT(rNode, newNode);
+    return placeNodeRRTStar(rNode, newNode);
+}
+
+bool RandomTreeClass::saveSnapshot(const std::string& fileName){
+    if(snapshot == NULL){
+        /* palette entry k is the color of cell state k
+        */
+        std::vector<rgba_t> palette;
+        for(int k = FREE; k <= END_CELL; k++){
+            colorVal cVal = getColorFromState((cellState)k);
+            palette.push_back({(unsigned char)(cVal.R * 255), (unsigned char)(cVal.G * 255),
+                               (unsigned char)(cVal.B * 255), 255});
+        }
+        snapshot = new SnapshotClass(N, snapshotCellSize, palette);
+        snapshot->setLineStyle({0, 0, 255, (unsigned char)(nodeConnectionAlpha * 255)},
+                               {255, 0, 0, (unsigned char)(pathHighlightAlpha * 255)},
+                               pathHighlightWidth);
+    }
+    /* every node but the root has an edge to its parent
+    */
+    std::vector<snapshotLine_t> edges;
+    edges.reserve(mp.size());
+    for(auto it = mp.begin(); it != mp.end(); it++){
+        if(it->second->parent != NULL)
+            edges.push_back({it->second->parent->pos, it->first});
+    }
+    snapshot->render(cellMap, edges, path);
+
+    std::string extension = fileName.substr(fileName.find_last_of('.') + 1);
+    if(extension == "ppm")
+        return snapshot->writePPM(fileName);
+    return snapshot->writePNG(fileName);
+}
+
 /* first step in path generation, a random node in free space
  * is generated
 */
 std::pair<int, int> RandomTreeClass::getRandomCell(void){
+    STATS_PHASE(timer, PHASE_SAMPLE);
     std::pair<int, int> randomCell;
     int randomX, randomY;
+    /* the end cell is never an obstacle
+    */
+    if(sampler == GOAL_BIASED_SAMPLER && getRandomAmount(0, 100) < goalBias){
+        LOG_TRACE(LOG_PLANNER, "Random Node (goal) "<<endX<<","<<endY);
+        return std::make_pair(endX, endY);
+    }
     /* retry if the random cell is not valid
     */
     while(1){
@@ -64,8 +238,9 @@ std::pair<int, int> RandomTreeClass::getRandomCell(void){
             randomCell = std::make_pair(randomX, randomY);
             break;
         }
+        STATS_COUNT(COUNT_SAMPLES_REJECTED);
     }
-    std::cout<<"Random Node "<<randomX<<","<<randomY<<std::endl;
+    LOG_TRACE(LOG_PLANNER, "Random Node "<<randomX<<","<<randomY);
     return randomCell;
 }
 
@@ -73,6 +248,7 @@ std::pair<int, int> RandomTreeClass::getRandomCell(void){
  * all nodes using the map
 */
 std::pair<int, int> RandomTreeClass::getNearestNode(std::pair<int, int> rNode){
+    STATS_PHASE(timer, PHASE_NEAREST);
     float minDistance = INT_MAX;
     /* nearest node coords
     */
@@ -95,21 +271,27 @@ std::pair<int, int> RandomTreeClass::getNearestNode(std::pair<int, int> rNode){
 
 /* The generated node has to be in the free space, and the path 
  * connecting it and the nearest node shouldn't pass through any 
- * obstacle
+ * obstacle. This only reads cellMap, so it is safe to be called
+ * from multiple threads at once
 */
-bool RandomTreeClass::isNodeValid(std::pair<int, int> nearestNode, std::pair<int, int>& newNode){
+bool RandomTreeClass::isSegmentValid(const int *cells, std::pair<int, int> nearestNode, 
+std::pair<int, int>& newNode, bool& goalReached){
+    STATS_PHASE(timer, PHASE_COLLISION);
     int nearX = nearestNode.first;
     int nearY = nearestNode.second;
 
     int newX = newNode.first;
     int newY = newNode.second;
 
+    goalReached = false;
     /* the connectTwoCells outputs the input (i,j) cell
      * as well, so no need to test it separately, but we
-     * do need to skip the check for the nearest node
+     * do need to skip the check for the nearest node. The
+     * points go to a scratch buffer per thread since the batch
+     * workers check segments at the same time
     */
-    std::vector<std::pair<int, int> > points;
-    points = connectTwoCells(nearX, nearY, newX, newY);
+    thread_local std::vector<std::pair<int, int> > points;
+    connectTwoCells(nearX, nearY, newX, newY, points);
 
     int px, py;
     for(int k = 0; k < points.size(); k++){ 
@@ -120,27 +302,47 @@ bool RandomTreeClass::isNodeValid(std::pair<int, int> nearestNode, std::pair<int
         if(px == nearX && py == nearY)
             continue;
 
-        if(isCellObstacle(px, py))
+        if(cells[getIdx(px, py)] == OBSTACLE)
             return false;  
 
         /* if the line from nearest node and generated node passes
          * through the end cell block
         */ 
-        if(isCellEndCell(px, py)){
+        if(isCellEndCell(cells, px, py)){
             /* rewrite the generate node
             */
-            pathFound = true;
+            goalReached = true;
             newNode = std::make_pair(px, py);
-            std::cout<<"Path Found while validation"<<std::endl;
             return true;
         }
     }
     return true;
 }
 
-bool RandomTreeClass::computeNewNodeAndValidate(std::pair<int, int> rNode, 
-std::pair<int, int>& newNode){
-    std::pair<int, int> nearestNode = getNearestNode(rNode);
+bool RandomTreeClass::isSegmentValid(std::pair<int, int> nearestNode, std::pair<int, int>& newNode,
+bool& goalReached){
+    return isSegmentValid(cellMap, nearestNode, newNode, goalReached);
+}
+
+bool RandomTreeClass::isNodeValid(std::pair<int, int> nearestNode, std::pair<int, int>& newNode){
+    TRACE_SPAN(span, "isNodeValid");
+    bool goalReached;
+    if(!isSegmentValid(nearestNode, newNode, goalReached))
+        return false;
+
+    if(goalReached){
+        pathFound = true;
+        LOG_DEBUG(LOG_PLANNER, "Path Found while validation");
+    }
+    return true;
+}
+
+/* compute the node that is step away from the nearest node along
+ * the line connecting it to the random node
+*/
+std::pair<int, int> RandomTreeClass::computeNewNode(std::pair<int, int> rNode, 
+std::pair<int, int> nearestNode){
+    STATS_PHASE(timer, PHASE_STEER);
     int nearX = nearestNode.first;
     int nearY = nearestNode.second;
 
@@ -162,13 +364,19 @@ std::pair<int, int>& newNode){
         newNodeX = ((1 - t) * nearX) + (t * rNode.first);
         newNodeY = ((1 - t) * nearY) + (t * rNode.second);
     }
+    return std::make_pair(newNodeX, newNodeY);
+}
 
+bool RandomTreeClass::computeNewNodeAndValidate(std::pair<int, int> rNode, 
+std::pair<int, int>& newNode){
+    std::pair<int, int> nearestNode = getNearestNode(rNode);
     /* NOTE: there is a chance that we find the end cell block
      * while validation, in that case we will overwrite newNodeX,Y
     */
-    newNode = std::make_pair(newNodeX, newNodeY);
+    newNode = computeNewNode(rNode, nearestNode);
     if(!isNodeValid(nearestNode, newNode)){
-        std::cout<<"Retrying . . . [Invalid new node]"<<std::endl;
+        LOG_DEBUG(LOG_PLANNER, "Retrying . . . [Invalid new node]");
+        STATS_COUNT(COUNT_INVALID_NODE);
         return false;
     }    
     return true;
@@ -193,21 +401,24 @@ std::pair<int, int> newNode){
         */
         if(isGoalReached(newNode))
             pathFound = true;
-        /* set cell state
+        /* set cell state, a headless planner does not own its grid
         */
-        setCellAsNode(newNode.first, newNode.second);
-        /* add connection path
-        */
-        setCellAsNodeConnectionStream(nearestNode.first, nearestNode.second, 
-        newNode.first, newNode.second);
+        if(!headless){
+            setCellAsNode(newNode.first, newNode.second);
+            /* add connection path
+            */
+            genEdgeLine(nearestNode, newNode);
+        }
         numNodesAdded++;
+        STATS_COUNT(COUNT_NODES_ADDED);
         return true;
     }
     /* if you are here, then createNode() failed, so we need to
      * retry again
     */
    else{
-        std::cout<<"Retrying . . . [New node already exists]"<<std::endl;
+        LOG_DEBUG(LOG_PLANNER, "Retrying . . . [New node already exists]");
+        STATS_COUNT(COUNT_NODE_EXISTS);
         return false;
    }
 
@@ -225,10 +436,8 @@ bool RandomTreeClass::placeNodeRRT(std::pair<int, int> rNode, std::pair<int, int
     /* save the nearest node
     */
     std::pair<int, int> nearestNode = getNearestNode(rNode);
-    int nearX = nearestNode.first;
-    int nearY = nearestNode.second;
-    std::cout<<"Nearest Node: "<<nearX<<","<<nearY<<std::endl;
-    std::cout<<"New Node placed: "<<newNode.first<<","<<newNode.second<<std::endl;
+    LOG_TRACE(LOG_PLANNER, "Nearest Node: "<<nearestNode.first<<","<<nearestNode.second);
+    LOG_TRACE(LOG_PLANNER, "New Node placed: "<<newNode.first<<","<<newNode.second);
 
     return createAndConnectNewNode(nearestNode, newNode);
 }
@@ -236,17 +445,26 @@ bool RandomTreeClass::placeNodeRRT(std::pair<int, int> rNode, std::pair<int, int
 /* node placement algorithm for RRT*
 */
 bool RandomTreeClass::placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int, int>& newNode){
+    TRACE_SPAN(span, "placeNodeRRTStar");
     /* this step is same as RRT, find newNode that is step away 
      * from the nearest node
     */
     if(!computeNewNodeAndValidate(rNode, newNode))
         return false;    
 
-    std::cout<<"New Node: "<<newNode.first<<","<<newNode.second<<std::endl;
+    return connectNewNodeRRTStar(newNode);
+}
+
+/* connect an already validated newNode to its min cost neighbor and
+ * rewire the neighborhood through it
+*/
+bool RandomTreeClass::connectNewNodeRRTStar(std::pair<int, int>& newNode){
+    LOG_TRACE(LOG_PLANNER, "New Node: "<<newNode.first<<","<<newNode.second);
 
     float minCost = INT_MAX;
     node_t *minCostNeighborNode;
-    std::vector<node_t*> neighborhoodNodes;
+    neighborhoodNodes.clear();
+    STATS_PHASE(parentTimer, PHASE_PARENT);
 
     /* find nodes that are within the neighborhood distance of 
      * newNode and compute minimum cost path to newNode
@@ -263,7 +481,8 @@ bool RandomTreeClass::placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int,
              * hood node connection to newNode
             */ 
             if(!isNodeValid(currNodePos, newNode)){
-                std::cout<<"Retrying . . . [Invalid new node]"<<std::endl;
+                LOG_DEBUG(LOG_PLANNER, "Retrying . . . [Invalid new node]");
+                STATS_COUNT(COUNT_INVALID_NODE);
                 continue;
             }  
             /* if path has been found with newNode (may or may not have 
@@ -289,8 +508,8 @@ bool RandomTreeClass::placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int,
             getDistanceBetweenCells(newNode.first, newNode.second, 
             currNodePos.first, currNodePos.second);
 
-            std::cout<<"Neighborhood Node: "<<currNodePos.first<<","<<currNodePos.second<<" ";
-            std::cout<<"Cost To New Node: "<<d<<std::endl;
+            LOG_TRACE(LOG_PLANNER, "Neighborhood Node: "<<currNodePos.first<<","
+            <<currNodePos.second<<" Cost To New Node: "<<d);
 
             /* save min cost node
             */
@@ -302,8 +521,9 @@ bool RandomTreeClass::placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int,
         }
     }
 
-    std::cout<<"Min Cost Neighbor Node: "<<minCostNeighborNode->pos.first<<","
-    <<minCostNeighborNode->pos.second<<std::endl;
+    LOG_TRACE(LOG_PLANNER, "Min Cost Neighbor Node: "<<minCostNeighborNode->pos.first<<","
+    <<minCostNeighborNode->pos.second);
+    STATS_STOP(parentTimer);
 
     /* add edge from min cost neighbor node to new node
     */
@@ -314,33 +534,278 @@ bool RandomTreeClass::placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int,
      * the newNode
     */
    
+    STATS_PHASE(rewireTimer, PHASE_REWIRE);
     node_t* currNode = getNodeFromCell(newNode.first, newNode.second);
     for(int k = 0; k < neighborhoodNodes.size(); k++){
         float dToNNode = getDistanceToRoot(neighborhoodNodes[k]);
 
-        std::cout<<"Neighborhood Node: "<<neighborhoodNodes[k]->pos.first<<","
-        <<neighborhoodNodes[k]->pos.second<<" ";
-        std::cout<<"dToNNode: "<<dToNNode<<std::endl;
+        LOG_TRACE(LOG_PLANNER, "Neighborhood Node: "<<neighborhoodNodes[k]->pos.first<<","
+        <<neighborhoodNodes[k]->pos.second<<" dToNNode: "<<dToNNode);
 
         float dNewBridge = getDistanceBetweenCells(newNode.first, newNode.second, 
         neighborhoodNodes[k]->pos.first, neighborhoodNodes[k]->pos.second);
-        std::cout<<"dNewBridge: "<<dNewBridge<<std::endl;
+        LOG_TRACE(LOG_PLANNER, "dNewBridge: "<<dNewBridge);
 
         float dNewRoute = getDistanceToRoot(currNode) + dNewBridge;
-        std::cout<<"dNewRoute: "<<dNewRoute<<std::endl;
+        LOG_TRACE(LOG_PLANNER, "dNewRoute: "<<dNewRoute);
 
         if(dNewRoute < dToNNode){
-            std::cout<<"Rerouting . . ."<<std::endl;
+            LOG_DEBUG(LOG_PLANNER, "Rerouting . . .");
+            STATS_COUNT(COUNT_REROUTES);
             if(!removeEdge(neighborhoodNodes[k]->parent, neighborhoodNodes[k]))
                 assert(false);
             if(!addEdge(currNode, neighborhoodNodes[k]))
                 assert(false);
+            /* move the drawn edge to the new parent
+            */
+            if(!headless)
+                genEdgeLine(newNode, neighborhoodNodes[k]->pos);
         }
     }
     
     return true;
 }
 
+/* batch mode worker, computes the nearest node and validates the
+ * new node for candidates in [start, end). The tree and the grid are
+ * not modified while the workers are running, so they only read the
+ * frozen snapshot
+*/
+void RandomTreeClass::computeCandidates(int start, int end){
+    for(int k = start; k < end; k++){
+        candidate_t& candidate = candidates[k];
+        candidate.nearestNode = getNearestNode(candidate.rNode);
+        candidate.newNode = computeNewNode(candidate.rNode, candidate.nearestNode);
+        candidate.valid = isSegmentValid(candidate.nearestNode, candidate.newNode, 
+        candidate.goalReached);
+    }
+}
+
+/* the batch is split evenly across the workers, chunk 0 is computed
+ * by the planner thread itself
+*/
+void RandomTreeClass::computeCandidatesChunk(int chunkIdx){
+    int chunk = (batchSize + numWorkers - 1)/numWorkers;
+    int start = chunkIdx * chunk;
+    if(start < batchSize)
+        computeCandidates(start, std::min(start + chunk, batchSize));
+}
+
+/* waits for the next batch, computes its chunk and reports back, until
+ * the workers are stopped
+*/
+void RandomTreeClass::batchWorker(int chunkIdx){
+    long generation = 0;
+    std::unique_lock<std::mutex> lock(batchMtx);
+    while(true){
+        batchCv.wait(lock, [this, generation]{ return stopBatch || batchGeneration != generation; });
+        if(stopBatch)
+            return;
+        generation = batchGeneration;
+
+        lock.unlock();
+        computeCandidatesChunk(chunkIdx);
+        lock.lock();
+        if(--numBatchWorkersBusy == 0)
+            batchDoneCv.notify_one();
+    }
+}
+
+void RandomTreeClass::startBatchWorkers(void){
+    stopBatch = false;
+    for(int k = 1; k < numWorkers; k++)
+        batchWorkers.push_back(std::thread(&RandomTreeClass::batchWorker, this, k));
+}
+
+void RandomTreeClass::stopBatchWorkers(void){
+    {
+        std::lock_guard<std::mutex> lock(batchMtx);
+        stopBatch = true;
+    }
+    batchCv.notify_all();
+    for(int k = 0; k < batchWorkers.size(); k++)
+        batchWorkers[k].join();
+    batchWorkers.clear();
+}
+
+/* nodes committed earlier in the same batch were not part of the
+ * snapshot, if one of them is closer to the random node than the
+ * saved nearest node then the candidate conflicts and has to be
+ * recomputed against the live tree
+*/
+bool RandomTreeClass::revalidateCandidate(candidate_t& candidate){
+    float minDistance = getDistanceBetweenCells(candidate.rNode.first, candidate.rNode.second,
+    candidate.nearestNode.first, candidate.nearestNode.second);
+    bool conflict = false;
+
+    for(int k = 0; k < batchNodes.size(); k++){
+        float d = getDistanceBetweenCells(candidate.rNode.first, candidate.rNode.second,
+        batchNodes[k].first, batchNodes[k].second);
+        if(d < minDistance){
+            minDistance = d;
+            candidate.nearestNode = batchNodes[k];
+            conflict = true;
+        }
+    }
+    if(conflict){
+        candidate.newNode = computeNewNode(candidate.rNode, candidate.nearestNode);
+        candidate.valid = isSegmentValid(candidate.nearestNode, candidate.newNode, 
+        candidate.goalReached);
+    }
+    return candidate.valid;
+}
+
+/* speculative batched extension, sample batchSize random nodes, find
+ * the nearest node and validate all of them in parallel, then commit
+ * the valid ones in order. Returns true if a node was added
+*/
+bool RandomTreeClass::placeNodesBatch(std::pair<int, int>& newNode){
+    candidates.resize(batchSize);
+    batchNodes.clear();
+    /* sampling is cheap compared to the nearest node search, so it
+     * is done here
+    */
+    for(int k = 0; k < batchSize; k++)
+        candidates[k].rNode = getRandomCell();
+
+    /* the workers are created once and woken for every batch, the
+     * planner thread computes the first chunk meanwhile
+    */
+    if(batchWorkers.size() == 0 && numWorkers > 1)
+        startBatchWorkers();
+    {
+        std::lock_guard<std::mutex> lock(batchMtx);
+        batchGeneration++;
+        numBatchWorkersBusy = batchWorkers.size();
+    }
+    batchCv.notify_all();
+    computeCandidatesChunk(0);
+    {
+        std::unique_lock<std::mutex> lock(batchMtx);
+        batchDoneCv.wait(lock, [this]{ return numBatchWorkersBusy == 0; });
+    }
+
+    /* commit survivors in order
+    */
+    bool nodeAdded = false;
+    for(int k = 0; k < batchSize; k++){
+        candidate_t& candidate = candidates[k];
+        if(!revalidateCandidate(candidate)){
+            LOG_DEBUG(LOG_PLANNER, "Retrying . . . [Invalid new node]");
+            STATS_COUNT(COUNT_INVALID_NODE);
+            continue;
+        }
+        if(candidate.goalReached){
+            pathFound = true;
+            LOG_DEBUG(LOG_PLANNER, "Path Found while validation");
+        }
+
+        newNode = candidate.newNode;
+#if RAPID_RANDOM_TREE == 1
+        if(!createAndConnectNewNode(candidate.nearestNode, newNode))
+            continue;
+#endif
+#if RAPID_RANDOM_TREE_STAR == 1
+        if(!connectNewNodeRRTStar(newNode))
+            continue;
+#endif
+        batchNodes.push_back(newNode);
+        nodeAdded = true;
+        /* the rest of the batch is dropped once the goal is reached
+        */
+        if(pathFound)
+            break;
+    }
+    return nodeAdded;
+}
+
+/* shared tree worker, grows the shared tree using its own random engine
+ * and the grid snapshot until the goal is reached, the tree is full or
+ * the workers are stopped
+*/
+void RandomTreeClass::sharedTreeWorker(unsigned int seed){
+    std::default_random_engine eng(seed);
+    std::uniform_int_distribution<int> distr(0, N-1);
+    const int *cells = cellSnapshot.data();
+
+    while(!stopWorkers.load(std::memory_order_acquire)){
+        std::pair<int, int> rNode = std::make_pair(distr(eng), distr(eng));
+        if(cells[getIdx(rNode.first, rNode.second)] == OBSTACLE)
+            continue;
+
+        int nearestIdx = sharedTree->getNearestNode(rNode);
+        std::pair<int, int> nearestNode = sharedTree->getNodePos(nearestIdx);
+        std::pair<int, int> newNode = computeNewNode(rNode, nearestNode);
+
+        bool goalReached;
+        if(!isSegmentValid(cells, nearestNode, newNode, goalReached))
+            continue;
+        /* fails if another worker already placed a node at this cell
+        */
+        if(sharedTree->insertNode(newNode, nearestIdx) < 0){
+            if(sharedTree->getNumReserved() == sharedTreeCapacity)
+                break;
+            continue;
+        }
+        if(goalReached || isGoalReached(cells, newNode))
+            stopWorkers.store(true, std::memory_order_release);
+    }
+}
+
+void RandomTreeClass::startSharedTreeWorkers(void){
+    if(sharedTree == NULL){
+        sharedTree = new SharedTreeClass(N, sharedTreeCapacity, step);
+        /* the root is the start cell, which is already part of the tree
+        */
+        sharedTree->insertNode(std::make_pair(startX, startY), -1);
+        numNodesMirrored = 1;
+    }
+    /* the workers only read the snapshot, so the grid can be updated
+     * while they are running
+    */
+    cellSnapshot.assign(cellMap, cellMap + N * N);
+    stopWorkers.store(false, std::memory_order_release);
+
+    std::random_device rd;
+    for(int k = 0; k < numWorkers; k++)
+        treeWorkers.push_back(std::thread(&RandomTreeClass::sharedTreeWorker, this, rd()));
+}
+
+void RandomTreeClass::stopSharedTreeWorkers(void){
+    stopWorkers.store(true, std::memory_order_release);
+    for(int k = 0; k < treeWorkers.size(); k++)
+        treeWorkers[k].join();
+    treeWorkers.clear();
+
+    if(sharedTree != NULL)
+        assert(sharedTree->verifyIntegrity());
+}
+
+/* mirror the nodes published by the workers into the tree and the grid
+ * in the order they were appended, a parent is always appended before its
+ * children. Returns true if a node was added
+*/
+bool RandomTreeClass::placeNodesShared(std::pair<int, int>& newNode){
+    if(treeWorkers.size() == 0)
+        startSharedTreeWorkers();
+
+    bool nodeAdded = false;
+    int numNodes = sharedTree->getNumReserved();
+    while(numNodesMirrored < numNodes && sharedTree->isNodeReady(numNodesMirrored)){
+        int idx = numNodesMirrored++;
+        newNode = sharedTree->getNodePos(idx);
+        std::pair<int, int> parentNode = sharedTree->getNodePos(sharedTree->getParentIdx(idx));
+
+        if(createAndConnectNewNode(parentNode, newNode))
+            nodeAdded = true;
+        if(pathFound)
+            break;
+    }
+    if(pathFound)
+        stopSharedTreeWorkers();
+    return nodeAdded;
+}
+
 /* check if one of the 8 neighbors is an end cell. 
  * This is when we move the end cell block after a path
  * has already been found
@@ -348,7 +813,7 @@ bool RandomTreeClass::placeNodeRRTStar(std::pair<int, int> rNode, std::pair<int,
  * In case of normal operation, check if the cell itself
  * is an end cell
 */
-bool RandomTreeClass::isGoalReached(std::pair<int, int> dNode){
+bool RandomTreeClass::isGoalReached(const int *cells, std::pair<int, int> dNode){
     int i = dNode.first;
     int j = dNode.second;
     
@@ -361,13 +826,17 @@ bool RandomTreeClass::isGoalReached(std::pair<int, int> dNode){
             if(j + c < 0 || j + c > N-1)
                 continue;
                 
-            if(isCellEndCell(i + r, j + c))
+            if(isCellEndCell(cells, i + r, j + c))
                 return true;
         }
     }
     return false;
 }
 
+bool RandomTreeClass::isGoalReached(std::pair<int, int> dNode){
+    return isGoalReached(cellMap, dNode);
+}
+
 /* check if a path already exists before starting the algorithm
 */
 bool RandomTreeClass::isPathAlreadyExist(std::pair<int, int>& lastNode){
@@ -459,74 +928,92 @@ void RandomTreeClass::setStartAndEndCells(void){
          * true to start the simulation
         */
         if(startCellSet && endCellSet){
-            std::cout<<"START CELL: "<<startX<<","<<startY
-                     <<" END CELL: "<<endX<<","<<endY<<std::endl;
+            LOG_INFO(LOG_PLANNER, "START CELL: "<<startX<<","<<startY
+                     <<" END CELL: "<<endX<<","<<endY);
             readyToStart = true;
+            checkExistingPath = true;
             /* add start cell to tree
             */
             if(createNode(std::make_pair(startX, startY)))
-                std::cout<<"Added START CELL to tree"<<std::endl;
+                LOG_INFO(LOG_TREE, "Added START CELL to tree");
             else
-                std::cout<<"START CELL already exists in map"<<std::endl;
+                LOG_INFO(LOG_TREE, "START CELL already exists in map");
         }
     }
 }
 
-void RandomTreeClass::simulationStep(void){
+/* runs one iteration of the algorithm, returns false if there was
+ * nothing to do (start and end cells not set, or waiting for the next
+ * step in step mode)
+*/
+bool RandomTreeClass::simulationStep(void){
 #if STEP_MODE == 1
-    if(stepMode){
-        /* add delay, this to enable single step mode
-        */
-        int delayCnt = 90000000;
-        while(delayCnt--);
+    /* set to true in process input fn once per key press
+    */
+    if(!stepMode)
+        return false;
+    stepMode = false;
 #endif
-        /* this is set to false via reset or if start and end cells have
-        * not been selected
+    /* this is set to false via reset or if start and end cells have
+    * not been selected
+    */
+    if(!readyToStart)
+        return false;
+    STATS_COUNT(COUNT_ITERATIONS);
+    TRACE_SPAN(span, "simulationStep");
+    ALLOC_SCOPE(allocs);
+
+#if SNAPSHOT_MODE == 1
+    if(numSteps % snapshotInterval == 0)
+        saveSnapshot(std::string(snapshotPrefix) + "_" + std::to_string(numSteps) + ".png");
+#endif
+    numSteps++;
+    /* holds last added node that reaced the end cell
+    */
+    std::pair<int, int> newNode;
+    /* STEP 0, check if a path already exists. The tree only changes
+     * through this loop, so this is needed only once after the end cell
+     * has been moved
+    */
+    if(checkExistingPath && isPathAlreadyExist(newNode))
+        pathFound = true;
+    else{
+        /* STEP1, get a valid random node
+        */
+#if BATCH_MODE == 1
+        placeNodesBatch(newNode);
+#elif SHARED_TREE_MODE == 1
+        placeNodesShared(newNode);
+#else
+        std::pair<int, int> rNode = getRandomCell();
+        /* STEP2, place node at step away from nearest node
         */
-        if(readyToStart){
-            /* holds last added node that reaced the end cell
-            */
-            std::pair<int, int> newNode;
-            /* STEP 0, check if a path already exists
-            */
-            if(isPathAlreadyExist(newNode))
-                pathFound = true;
-            else{
-                /* STEP1, get a valid random node
-                */
-                std::pair<int, int> rNode = getRandomCell();
-                /* STEP2, place node at step away from nearest node
-                */
 #if RAPID_RANDOM_TREE == 1
-                placeNodeRRT(rNode, newNode); 
+        placeNodeRRT(rNode, newNode); 
 #endif
 #if RAPID_RANDOM_TREE_STAR == 1
-                placeNodeRRTStar(rNode, newNode);
+        placeNodeRRTStar(rNode, newNode);
 #endif
-            }
-            /* STEP 3, check if you have reached end cell
-            */
-            if(pathFound){
-                /* clear previous path before computing a new one
-                */
-                if(path.size() != 0){
-                    deHighlightPath(path);
-                    path.clear();
-                }
-                
-                std::cout<<"Goal Reached !!! "<<newNode.first<<","<<newNode.second<<std::endl;
-                std::cout<<"Number of Nodes Added: "<<numNodesAdded<<std::endl;
-                path = getPath(newNode);
-                /* display path
-                */
-                highlightPath(path, END_CELL);
-                restartRenderLoop();
-            }   
-        }
-#if STEP_MODE == 1
-        /* set to true in process input fn
-        */ 
-        stepMode = false;
-    }
 #endif
+    }
+    checkExistingPath = false;
+    /* STEP 3, check if you have reached end cell
+    */
+    if(pathFound){
+        /* clear previous path before computing a new one
+        */
+        if(path.size() != 0){
+            deHighlightPath();
+            path.clear();
+        }
+        
+        LOG_INFO(LOG_PLANNER, "Goal Reached !!! "<<newNode.first<<","<<newNode.second);
+        LOG_INFO(LOG_PLANNER, "Number of Nodes Added: "<<numNodesAdded);
+        getPath(newNode, path);
+        /* display path
+        */
+        highlightPath(path);
+        restartRenderLoop();
+    }   
+    return true;
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #include "../../Include/Simulation/RandomTree.h"
 #include "../../Include/Utils/Common.h"
 #include <random>
+#include <climits>
+#include <cassert>
 #include <cmath> /* for for round(), pow(). sqrt()
 */
 
@@ -9,23 +11,35 @@ int RandomTreeClass::getIdx(int i, int j){
 }
 
 bool RandomTreeClass::isCellFree(int i, int j){
-    return cellCurr[getIdx(i, j)] == FREE;
+    return cellMap[getIdx(i, j)] == FREE;
 }
 
 bool RandomTreeClass::isCellObstacle(int i, int j){
-    return cellCurr[getIdx(i, j)] == OBSTACLE;
+    return cellMap[getIdx(i, j)] == OBSTACLE;
+}
+
+/* the shared grid of a headless planner has no end cells, so the end
+ * cell block is the free space within endCellWidth of the end cell
+*/
+bool RandomTreeClass::isCellEndCell(const int *cells, int i, int j){
+    if(headless)
+        return abs(i - endX) <= endCellWidth && abs(j - endY) <= endCellWidth &&
+               cells[getIdx(i, j)] != OBSTACLE;
+    return cells[getIdx(i, j)] == END_CELL;
 }
 
 bool RandomTreeClass::isCellEndCell(int i, int j){
-    return cellCurr[getIdx(i, j)] == END_CELL;
+    return isCellEndCell(cellMap, i, j);
 }
 
-void RandomTreeClass::setCellColorFromState(int i, int j, cellState state, float alpha){
-    colorVal cVal = state == FREE ? whiteVal : state == OBSTACLE ? blackVal :
-                    state == NODE ? blueVal : state == START_CELL ? greenVal :
-                    state == NODE_CONNECTION ? blueVal : redVal;
+colorVal RandomTreeClass::getColorFromState(cellState state){
+    return state == FREE ? whiteVal : state == OBSTACLE ? blackVal :
+           state == NODE ? blueVal : state == START_CELL ? greenVal :
+           state == NODE_CONNECTION ? blueVal : redVal;
+}
 
-    genCellColor(i, j, cVal, alpha);
+void RandomTreeClass::setCellColorFromState(int i, int j, cellState state, float alpha){
+    genCellColor(i, j, getColorFromState(state), alpha);
 }
 
 void RandomTreeClass::setCellBlockToState(int i, int j, cellState state, int width){
@@ -84,13 +98,6 @@ void RandomTreeClass::setCellAsNode(int i, int j){
     setCellColorFromState(i, j, NODE);
 }
 
-void RandomTreeClass::setCellAsNodeConnection(int i, int j){
-    cellCurr[getIdx(i, j)] = NODE_CONNECTION;
-    /* set color according to cell state
-    */
-    setCellColorFromState(i, j, NODE_CONNECTION, nodeConnectionAlpha);
-}
-
 /* different from other set functions, it saves the value
 */ 
 void RandomTreeClass::setCellAsStartCell(int i, int j){
@@ -123,7 +130,7 @@ void RandomTreeClass::setCellAsEndCell(int i, int j){
 void RandomTreeClass::setCellAsObstacleStream(int i1, int j1, int i2, int j2, const int width, 
                                               widthType wType){
     std::vector<std::pair<int, int> > points;
-    points = connectTwoCells(i1, j1, i2, j2);
+    connectTwoCells(i1, j1, i2, j2, points);
 
     int j, px, py;
     for(int i = 0; i < points.size(); i++){
@@ -140,48 +147,14 @@ void RandomTreeClass::setCellAsObstacleStream(int i1, int j1, int i2, int j2, co
     }
 }
 
-void RandomTreeClass::setCellAsNodeConnectionStream(int i1, int j1, int i2, int j2){
-    std::vector<std::pair<int, int> > points;
-    /* returns set of points between (i1,j1) and (i2,j2) included
-    */
-    points = connectTwoCells(i1, j1, i2, j2);
-
-    for(int i = 0; i < points.size(); i++){
-        int px = points[i].first;
-        int py = points[i].second;
-        /* NOTE: we need to exclude the points (i1,j1) and (i2,j2) from
-         * points vector
-        */
-        if((px == i1 && py == j1) || (px == i2 && py == j1))
-            continue;
-        setCellAsNodeConnection(px, py); 
-    }
-}
-
-/* remove path between two nodes
-*/
-void RandomTreeClass::clearNodeConnectionStream(int i1, int j1, int i2, int j2){
-    std::vector<std::pair<int, int> > points;
-    points = connectTwoCells(i1, j1, i2, j2);
-
-    for(int i = 0; i < points.size(); i++){
-        int px = points[i].first;
-        int py = points[i].second;
-        /* NOTE: we need to exclude the points (i1,j1) and (i2,j2) from
-         * points vector
-        */
-        if((px == i1 && py == j1) || (px == i2 && py == j1))
-            continue;
-        setCellAsFree(px, py); 
-    }
-}
-
-/* return cell coordinates between (i1,j1) and (i2,j2), both end
- * points included
+/* cell coordinates between (i1,j1) and (i2,j2), both end points
+ * included, are written to points. The vector is reused by the caller,
+ * so it is only allocated once
 */
-std::vector<std::pair<int, int> > RandomTreeClass::connectTwoCells
-(int i1, int j1, int i2, int j2){
-    std::vector<std::pair<int, int> > points;
+void RandomTreeClass::connectTwoCells(int i1, int j1, int i2, int j2, 
+std::vector<std::pair<int, int> >& points){
+    points.clear();
+    points.reserve(N + 1);
     /* get slope
     */
     double dy = j2 - j1;
@@ -205,7 +178,6 @@ std::vector<std::pair<int, int> > RandomTreeClass::connectTwoCells
     /* do not forget to add the destination point as well (i2, j2)
     */
     points.push_back(std::make_pair(i2, j2));
-    return points;
 }
 
 /* we don't change the cellCurr value for the highlighted cells,
@@ -241,46 +213,15 @@ void RandomTreeClass::highlightCell(int i, int j, cellState state){
     }
 }
 
-/* path contains cell/node coords
+/* path contains cell/node coords, the path is drawn as a thick
+ * line over the grid and does not touch the cells
 */
-void RandomTreeClass::highlightPath(std::vector<std::pair<int, int>> path, cellState state){
-    int width = pathHighlightWidth;
-    float alpha = state == FREE ? 1.0 : pathHighlightAlpha;
-
-    int n = path.size();
+void RandomTreeClass::highlightPath(const std::vector<std::pair<int, int>>& path){
     /* something wrong if the path has only node coord
     */
-    if(n < 2)
+    if(path.size() < 2)
         assert(false);
-
-    int i = n - 1;
-    while(i >= 1){
-        int p1x = path[i].first;
-        int p1y = path[i].second;
-        i--;
-
-        int p2x = path[i].first;
-        int p2y = path[i].second;
-
-        std::vector<std::pair<int, int> > points = connectTwoCells(p1x, p1y, p2x, p2y);
-        for(int k = 0; k < points.size(); k++){
-            for(int r = -width; r <= width; r++){
-                for(int c = -width; c<= width; c++){
-                    /* boundary guards
-                    */
-                    if(points[k].first + r < 0 || points[k].first + r > N-1)
-                        continue;
-                    if(points[k].second + c < 0 || points[k].second + c > N-1)
-                        continue;
-
-                    /* highlight only over free cells, and in the x direction only
-                    */
-                    if(isCellFree(points[k].first + r, points[k].second + c))
-                        setCellColorFromState(points[k].first + r, points[k].second + c, state, alpha); 
-                }
-            }
-        }
-    }
+    genPathLines(path);
 }
 
 void RandomTreeClass::deHighlightCell(int i, int j){
@@ -289,8 +230,8 @@ void RandomTreeClass::deHighlightCell(int i, int j){
     highlightCell(i, j, FREE);
 }
 
-void RandomTreeClass::deHighlightPath(std::vector<std::pair<int, int>> path){
-    highlightPath(path, FREE);
+void RandomTreeClass::deHighlightPath(void){
+    genPathLines(std::vector<std::pair<int, int>>());
 }
 
 void RandomTreeClass::restartRenderLoop(void){
@@ -310,19 +251,15 @@ void RandomTreeClass::restartRenderLoop(void){
 /* given a start and an end range, generate a random number.
 */
 int RandomTreeClass::getRandomAmount(int start, int end){
-    /* At first, the std::random_device object should be 
-     * initialized. It produces non-deterministic random bits 
-     * for random engine seeding, which is crucial to avoid 
-     * producing the same number sequences. Here we use std::
-     * default_random_engine to generate pseudo-random values, 
-     * but you can declare specific algorithm engine. Next, we
-     * initialize a uniform distribution and pass min/max values
-     * as optional arguments.
+    /* The random engine is seeded once when the planner is created,
+     * with a std::random_device for the simulation and with a given
+     * seed for a headless planner, so that runs can be repeated. Seeding
+     * a new engine on every call is slow and the sequences are not any
+     * more random. Next, we initialize a uniform distribution and pass
+     * min/max values as optional arguments.
     */
-    std::random_device rd;
-    std::default_random_engine eng(rd());
     std::uniform_real_distribution<> distr(start, end);
-    return distr(eng);
+    return distr(randomEngine);
 }
 
 float RandomTreeClass::getDistanceBetweenCells(int i1, int j1, int i2, int j2){
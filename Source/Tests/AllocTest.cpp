@@ -0,0 +1,117 @@
+#include "../../Include/Simulation/RandomTree.h"
+#include "../../Include/Simulation/Constants.h"
+#include "../../Include/Utils/Alloc.h"
+#include <iostream>
+#include <vector>
+
+/* Checks that the planning loop does not allocate once it is warmed up,
+ * except for the blocks the arena adds while the tree grows through
+ * them, and that solving a query stays within the same budget plus the
+ * growth of the path. Must be built with -DALLOC_TRACKING=1, returns
+ * non zero on failure
+*/
+class AllocTestClass{
+    private:
+        /* small blocks, so the arena grows every few hundred nodes
+        */
+        static const size_t blockSize = 1 << 16;
+        static const int minBlocks = 8;
+        static const int warmupIterations = 100;
+        static const int maxIterations = 200000;
+        static const int testN = 800;
+
+    public:
+        bool run(plannerType planner){
+            const char *name = planner == RRT ? "RRT" : "RRT*";
+            std::vector<int> cells(testN * testN, FREE);
+            ArenaClass arena(blockSize);
+            RandomTreeClass p(step, neighborhood, testN, cells.data(), planner, 1, &arena);
+            p.setNoGoal();
+            p.createNode(std::make_pair(testN/2, testN/2));
+
+            int k = 0;
+            uint64_t warmCount = 0;
+            int warmBlocks = 0;
+            for(; k < maxIterations && arena.getUsedBytes() < minBlocks * blockSize; k++){
+                if(k == warmupIterations){
+                    warmCount = allocGetCount();
+                    warmBlocks = arena.getNumBlocks();
+                }
+                p.growOnce();
+            }
+            uint64_t count = allocGetCount() - warmCount;
+            /* one malloc per arena block, nothing else
+            */
+            uint64_t budget = arena.getNumBlocks() - warmBlocks;
+            if(arena.getUsedBytes() < minBlocks * blockSize){
+                std::cout<<"[ERROR] "<<name<<": the arena did not grow to "<<minBlocks
+                         <<" blocks in "<<maxIterations<<" iterations"<<std::endl;
+                return false;
+            }
+            if(count != budget){
+                std::cout<<"[ERROR] "<<name<<": "<<count<<" allocations after warm up for "<<budget
+                         <<" new arena blocks ("<<k<<" iterations, "<<p.getNumNodes()<<" nodes)"
+                         <<std::endl;
+                return false;
+            }
+            std::cout<<name<<": "<<count<<" allocations in "<<k - warmupIterations
+                     <<" iterations, all arena blocks, "<<p.getNumNodes()<<" nodes, "
+                     <<arena.getUsedBytes()/1024<<" KB of arena"<<std::endl;
+            return true;
+        }
+
+        /* the first query sizes the planner's buffers and the path, the
+         * second one grows the same tree to another goal. It may only
+         * add arena blocks, and the path vectors may double up to its
+         * length and be copied once to the caller
+        */
+        bool runSolve(plannerType planner){
+            const char *name = planner == RRT ? "RRT" : "RRT*";
+            std::vector<int> cells(testN * testN, FREE);
+            ArenaClass arena(blockSize);
+            RandomTreeClass p(step, neighborhood, testN, cells.data(), planner, 1, &arena);
+            std::pair<int, int> start = std::make_pair(testN/2, testN/2);
+            std::vector<std::pair<int, int>> solvedPath;
+            if(!p.solve(start, std::make_pair(testN/4, testN/4), maxIterations, NULL, solvedPath)){
+                std::cout<<"[ERROR] "<<name<<": the first query was not solved"<<std::endl;
+                return false;
+            }
+
+            uint64_t startCount = allocGetCount();
+            int startBlocks = arena.getNumBlocks();
+            bool solved = p.solve(start, std::make_pair(3 * testN/4, 3 * testN/4), maxIterations,
+                                  NULL, solvedPath);
+            uint64_t count = allocGetCount() - startCount;
+            if(!solved || solvedPath.size() < 2 || solvedPath.back() != start){
+                std::cout<<"[ERROR] "<<name<<": the second query was not solved"<<std::endl;
+                return false;
+            }
+            uint64_t budget = arena.getNumBlocks() - startBlocks + 1;
+            for(size_t length = 1; length < solvedPath.size(); length *= 2)
+                budget++;
+            if(count > budget){
+                std::cout<<"[ERROR] "<<name<<": "<<count<<" allocations to solve a query, "
+                         <<budget<<" allowed ("<<solvedPath.size()<<" path nodes, "
+                         <<arena.getNumBlocks() - startBlocks<<" new arena blocks)"<<std::endl;
+                return false;
+            }
+            std::cout<<name<<": "<<count<<" allocations to solve a query, "<<budget<<" allowed, "
+                     <<solvedPath.size()<<" path nodes"<<std::endl;
+            return true;
+        }
+};
+
+int main(void){
+#if ALLOC_TRACKING == 1
+    AllocTestClass test;
+    bool passed = test.run(RRT);
+    passed = test.run(RRT_STAR) && passed;
+    passed = test.runSolve(RRT) && passed;
+    passed = test.runSolve(RRT_STAR) && passed;
+    std::cout<<(passed ? "passed" : "failed")<<std::endl;
+    return passed ? 0 : 1;
+#else
+    std::cout<<"[ERROR] Build with -DALLOC_TRACKING=1 to count allocations"<<std::endl;
+    return 1;
+#endif
+}
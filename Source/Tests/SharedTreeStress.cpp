@@ -0,0 +1,150 @@
+#include "../../Include/Utils/SharedTree.h"
+#include <iostream>
+#include <vector>
+#include <thread>
+#include <random>
+#include <atomic>
+
+/* Grows shared trees from many threads at once on small grids, so that
+ * threads keep racing for the same cells and buckets, and checks every
+ * tree once the writers have stopped. Failures are printed and counted,
+ * returns non zero on failure
+*/
+class SharedTreeStressClass{
+    private:
+        static const int numThreads = 16;
+        static const int numRounds = 200;
+        static const int insertsPerThread = 2000;
+
+        /* what a thread saw while the tree was growing
+        */
+        typedef struct{
+            std::vector<std::pair<int, int>> inserted;
+            std::vector<int> insertedIdx;
+            int badNearest;
+        }threadResult_t;
+
+        int failures;
+
+        void fail(int round, const std::string& msg){
+            std::cout<<"[ERROR] Round "<<round<<": "<<msg<<std::endl;
+            failures++;
+        }
+
+        /* nearest node lookups and inserts interleave, like the planner
+         * workers, each new node hangs off the nearest node it found
+        */
+        static void worker(SharedTreeClass *tree, int N, unsigned int seed,
+        std::atomic<bool> *go, threadResult_t *result){
+            std::mt19937 engine(seed);
+            std::uniform_int_distribution<int> cellDist(0, N-1);
+            result->badNearest = 0;
+            while(!go->load(std::memory_order_acquire))
+                std::this_thread::yield();
+
+            for(int k = 0; k < insertsPerThread; k++){
+                std::pair<int, int> cellPos = std::make_pair(cellDist(engine), cellDist(engine));
+                int nearestIdx = tree->getNearestNode(cellPos);
+                /* the root is inserted before the threads start, so a
+                 * lookup always finds a node that is ready
+                */
+                if(nearestIdx < 0 || nearestIdx >= tree->getNumReserved() ||
+                !tree->isNodeReady(nearestIdx)){
+                    result->badNearest++;
+                    continue;
+                }
+                int idx = tree->insertNode(cellPos, nearestIdx);
+                if(idx >= 0){
+                    result->inserted.push_back(cellPos);
+                    result->insertedIdx.push_back(idx);
+                }
+            }
+        }
+
+        void runRound(int round, int N, int capacity, int bucketDim){
+            SharedTreeClass tree(N, capacity, bucketDim);
+            tree.insertNode(std::make_pair(N/2, N/2), -1);
+
+            std::atomic<bool> go(false);
+            std::vector<threadResult_t> results(numThreads);
+            std::vector<std::thread> workers;
+            for(int t = 0; t < numThreads; t++)
+                workers.push_back(std::thread(worker, &tree, N, round * numThreads + t, &go,
+                &results[t]));
+            go.store(true, std::memory_order_release);
+            for(int t = 0; t < numThreads; t++)
+                workers[t].join();
+
+            if(!tree.verifyIntegrity())
+                fail(round, "integrity check failed");
+
+            /* every successful insert owns a distinct slot holding its
+             * cell, and together with the root they are all the nodes
+            */
+            int numNodes = tree.getNumReserved();
+            std::vector<int> slotOwners(numNodes, 0);
+            std::vector<bool> cellTaken(N * N, false);
+            cellTaken[N/2 + (N/2) * N] = true;
+            int numInserted = 1;
+            for(int t = 0; t < numThreads; t++){
+                if(results[t].badNearest > 0)
+                    fail(round, "thread " + std::to_string(t) + " got " +
+                    std::to_string(results[t].badNearest) + " invalid nearest nodes");
+                for(int k = 0; k < results[t].insertedIdx.size(); k++){
+                    int idx = results[t].insertedIdx[k];
+                    std::pair<int, int> cellPos = results[t].inserted[k];
+                    if(idx <= 0 || idx >= numNodes){
+                        fail(round, "insert returned slot " + std::to_string(idx));
+                        continue;
+                    }
+                    slotOwners[idx]++;
+                    if(tree.getNodePos(idx) != cellPos)
+                        fail(round, "slot " + std::to_string(idx) + " holds another cell");
+                    int cellIdx = cellPos.first + cellPos.second * N;
+                    if(cellTaken[cellIdx])
+                        fail(round, "two nodes at cell (" + std::to_string(cellPos.first) + ", " +
+                        std::to_string(cellPos.second) + ")");
+                    cellTaken[cellIdx] = true;
+                    numInserted++;
+                }
+            }
+            if(numInserted != numNodes)
+                fail(round, std::to_string(numInserted) + " inserts succeeded but the tree has " +
+                std::to_string(numNodes) + " nodes");
+            for(int k = 1; k < numNodes; k++){
+                if(slotOwners[k] != 1)
+                    fail(round, "slot " + std::to_string(k) + " returned " +
+                    std::to_string(slotOwners[k]) + " times");
+            }
+            if(numNodes > capacity)
+                fail(round, "the tree grew past its capacity");
+        }
+
+    public:
+        SharedTreeStressClass(void){
+            failures = 0;
+        }
+
+        /* grids of 8 to 64 cells, some rounds with a capacity smaller
+         * than the grid so that threads also race for the last slots
+        */
+        bool run(void){
+            const int gridSizes[] = {8, 16, 32, 64};
+            for(int round = 0; round < numRounds; round++){
+                int N = gridSizes[round % 4];
+                int capacity = (round/4) % 2 == 0 ? N * N : N * N/4;
+                int bucketDim = 1 + (round/8) % 4;
+                runRound(round, N, capacity, bucketDim);
+            }
+            std::cout<<numRounds<<" rounds of "<<numThreads<<" threads, "<<failures
+                     <<" failures"<<std::endl;
+            return failures == 0;
+        }
+};
+
+int main(void){
+    SharedTreeStressClass test;
+    bool passed = test.run();
+    std::cout<<(passed ? "passed" : "failed")<<std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,145 @@
+#include "../../Include/Visualization/Snapshot/Snapshot.h"
+#include <iostream>
+#include <fstream>
+#include <sstream>
+#include <iterator>
+#include <thread>
+#include <cstdio>
+
+/* Renders a fixed small state and compares the PNG and PPM files with
+ * the reference hashes below, renders with one and several threads must
+ * also be equal. If the drawing is changed on purpose, check the images
+ * it writes and paste the printed hashes in here. Returns non zero on
+ * failure
+*/
+class SnapshotTestClass{
+    private:
+        static const int testN = 24;
+        static const int cellSize = 3;
+        static const uint64_t referencePNG = 0x6d7abf94fb75dc39ull;
+        static const uint64_t referencePPM = 0x1ab966e28ddcbc63ull;
+
+        std::string outDir;
+        int failures;
+
+        /* FNV-1a
+        */
+        static uint64_t getHash(const std::string& bytes){
+            uint64_t hash = 0xcbf29ce484222325ull;
+            for(size_t k = 0; k < bytes.size(); k++){
+                hash ^= (unsigned char)bytes[k];
+                hash *= 0x100000001b3ull;
+            }
+            return hash;
+        }
+
+        static std::string readFile(const std::string& fileName){
+            std::ifstream file(fileName, std::ios::binary);
+            return std::string(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+        }
+
+        /* walls along two sides, an obstacle block, the start and end
+         * cells, a few tree edges and a path
+        */
+        void render(SnapshotClass& snapshot){
+            std::vector<int> cells(testN * testN, 0);
+            for(int k = 0; k < testN; k++){
+                cells[k] = 1;
+                cells[k * testN] = 1;
+            }
+            for(int i = 8; i < 14; i++)
+                for(int j = 10; j < 16; j++)
+                    cells[i + j * testN] = 1;
+            cells[3 + 3 * testN] = 2;
+            cells[20 + 20 * testN] = 3;
+            /* out of range, drawn with the first color
+            */
+            cells[5 + 18 * testN] = 42;
+
+            std::vector<snapshotLine_t> edges = {
+                {{3, 3}, {6, 9}}, {{6, 9}, {16, 8}}, {{16, 8}, {20, 20}}, {{3, 3}, {12, 2}},
+                {{12, 2}, {12, 2}}
+            };
+            std::vector<std::pair<int, int>> path = {{3, 3}, {6, 9}, {16, 8}, {20, 20}};
+            snapshot.setLineStyle({0, 0, 255, 160}, {255, 0, 0, 255}, 1);
+            snapshot.render(cells.data(), edges, path);
+        }
+
+        void check(const std::string& name, const std::string& bytes, uint64_t reference){
+            uint64_t hash = getHash(bytes);
+            if(bytes.size() == 0){
+                std::cout<<"[ERROR] "<<name<<" was not written"<<std::endl;
+                failures++;
+            }
+            else if(hash != reference){
+                std::cout<<"[ERROR] "<<name<<" hash 0x"<<std::hex<<hash<<" does not match the reference 0x"
+                         <<reference<<std::dec<<std::endl;
+                failures++;
+            }
+        }
+
+    public:
+        SnapshotTestClass(const std::string& _outDir){
+            outDir = _outDir;
+            failures = 0;
+        }
+
+        bool run(void){
+            std::vector<rgba_t> palette = {
+                {255, 255, 255, 255}, {40, 40, 40, 255}, {0, 200, 0, 255}, {200, 0, 200, 255}
+            };
+            std::string pngName = outDir + "/SnapshotTest.png";
+            std::string ppmName = outDir + "/SnapshotTest.ppm";
+
+            SnapshotClass snapshot(testN, cellSize, palette, 1);
+            render(snapshot);
+            snapshot.writePNG(pngName);
+            snapshot.writePPM(ppmName);
+            std::string png = readFile(pngName);
+            std::string ppm = readFile(ppmName);
+            check("PNG", png, referencePNG);
+            check("PPM", ppm, referencePPM);
+
+            /* the cells are split over the threads, the result is the same
+            */
+            SnapshotClass threaded(testN, cellSize, palette, 5);
+            render(threaded);
+            int numBytes = threaded.getImageDim() * threaded.getImageDim() * 4;
+            if(std::string((const char*)threaded.getPixels(), numBytes) !=
+            std::string((const char*)snapshot.getPixels(), numBytes)){
+                std::cout<<"[ERROR] Render with 5 threads differs from the one with 1"<<std::endl;
+                failures++;
+            }
+
+            /* several writers at once, each file must match
+            */
+            const int numWriters = 4;
+            std::vector<std::thread> writers;
+            for(int t = 0; t < numWriters; t++)
+                writers.push_back(std::thread([this, &threaded, t]{
+                    threaded.writePNG(outDir + "/SnapshotTest" + std::to_string(t) + ".png");
+                }));
+            for(int t = 0; t < numWriters; t++)
+                writers[t].join();
+            for(int t = 0; t < numWriters; t++){
+                std::string fileName = outDir + "/SnapshotTest" + std::to_string(t) + ".png";
+                check("PNG of writer " + std::to_string(t), readFile(fileName), referencePNG);
+                remove(fileName.c_str());
+            }
+
+            std::ostringstream hashes;
+            hashes<<std::hex<<"PNG 0x"<<getHash(png)<<", PPM 0x"<<getHash(ppm);
+            std::cout<<hashes.str()<<", "<<failures<<" failures"<<std::endl;
+            return failures == 0;
+        }
+};
+
+/* the images are written to the directory given as the argument, the
+ * current directory by default
+*/
+int main(int argc, char **argv){
+    SnapshotTestClass test(argc > 1 ? argv[1] : ".");
+    bool passed = test.run();
+    std::cout<<(passed ? "passed" : "failed")<<std::endl;
+    return passed ? 0 : 1;
+}
@@ -0,0 +1,143 @@
+#include "../../Include/Utils/Alloc.h"
+#include "../../Include/Utils/Stats.h"
+#include <stdlib.h>
+#include <new>
+
+#if ALLOC_TRACKING == 1
+#if defined(__GLIBC__)
+/* glibc also exports its allocator under these names, so malloc, calloc
+ * and realloc can be replaced with counted versions that call it
+*/
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t num, size_t size);
+extern "C" void* __libc_realloc(void *p, size_t size);
+#define ALLOC_COUNTS_MALLOC         1
+#elif defined(__APPLE__)
+/* malloc calls from the program itself bind to the counted versions
+ * below, which allocate from the default zone like the system malloc.
+ * Calls from inside the system libraries are not counted
+*/
+#include <malloc/malloc.h>
+#define ALLOC_COUNTS_MALLOC         1
+#else
+#define ALLOC_COUNTS_MALLOC         0
+#endif
+
+namespace{
+    /* constant initialized, so they can be used before and during
+     * static initialization
+    */
+    thread_local uint64_t numAllocs = 0;
+    thread_local uint64_t numBytes = 0;
+
+    void countAlloc(size_t size){
+        numAllocs++;
+        numBytes += size;
+    }
+
+    /* with malloc counted, operator new is counted through it
+    */
+    void* countedAlloc(size_t size){
+#if ALLOC_COUNTS_MALLOC == 0
+        countAlloc(size);
+#endif
+        return malloc(size == 0 ? 1 : size);
+    }
+}
+
+#if ALLOC_COUNTS_MALLOC == 1
+extern "C" void* malloc(size_t size){
+    countAlloc(size);
+#if defined(__GLIBC__)
+    return __libc_malloc(size);
+#else
+    return malloc_zone_malloc(malloc_default_zone(), size);
+#endif
+}
+
+extern "C" void* calloc(size_t num, size_t size){
+    countAlloc(num * size);
+#if defined(__GLIBC__)
+    return __libc_calloc(num, size);
+#else
+    return malloc_zone_calloc(malloc_default_zone(), num, size);
+#endif
+}
+
+/* a realloc is counted as an allocation, it may move the block
+*/
+extern "C" void* realloc(void *p, size_t size){
+    countAlloc(size);
+#if defined(__GLIBC__)
+    return __libc_realloc(p, size);
+#else
+    return malloc_zone_realloc(malloc_default_zone(), p, size);
+#endif
+}
+#endif
+
+void* operator new(size_t size){
+    void *p = countedAlloc(size);
+    if(p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](size_t size){
+    return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept{
+    return countedAlloc(size);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept{
+    return countedAlloc(size);
+}
+
+void operator delete(void *p) noexcept{
+    free(p);
+}
+
+void operator delete[](void *p) noexcept{
+    free(p);
+}
+
+void operator delete(void *p, size_t) noexcept{
+    free(p);
+}
+
+void operator delete[](void *p, size_t) noexcept{
+    free(p);
+}
+
+uint64_t allocGetCount(void){
+    return numAllocs;
+}
+
+uint64_t allocGetBytes(void){
+    return numBytes;
+}
+#else
+uint64_t allocGetCount(void){
+    return 0;
+}
+
+uint64_t allocGetBytes(void){
+    return 0;
+}
+#endif
+
+AllocScopeClass::AllocScopeClass(void){
+    startCount = allocGetCount();
+    startBytes = allocGetBytes();
+}
+
+AllocScopeClass::~AllocScopeClass(void){
+    statsCount(COUNT_ALLOCATIONS, allocGetCount() - startCount);
+    statsCount(COUNT_ALLOCATED_BYTES, allocGetBytes() - startBytes);
+}
+
+uint64_t AllocScopeClass::getCount(void){
+    return allocGetCount() - startCount;
+}
@@ -0,0 +1,73 @@
+#include "../../Include/Utils/Arena.h"
+#include <stdlib.h>
+#include <stdint.h>
+
+ArenaClass::ArenaClass(size_t _blockSize){
+    firstBlock = NULL;
+    blockSize = _blockSize;
+    currBlock = NULL;
+    offset = 0;
+    numBlocks = 0;
+}
+
+ArenaClass::~ArenaClass(void){
+    while(firstBlock != NULL){
+        arenaBlock_t *next = firstBlock->next;
+        free(firstBlock);
+        firstBlock = next;
+    }
+}
+
+void* ArenaClass::allocate(size_t size, size_t align){
+    /* align the offset into the current block, move to the next block
+     * (or create one) if the request does not fit
+    */
+    while(true){
+        if(currBlock != NULL){
+            uintptr_t base = (uintptr_t)(currBlock + 1);
+            size_t start = ((base + offset + align - 1) & ~(uintptr_t)(align - 1)) - base;
+            if(start + size <= currBlock->size){
+                offset = start + size;
+                return (char*)(currBlock + 1) + start;
+            }
+        }
+        arenaBlock_t *next = currBlock == NULL ? firstBlock : currBlock->next;
+        if(next == NULL){
+            /* oversized requests get a block of their own
+            */
+            size_t newBlockSize = size + align > blockSize ? size + align : blockSize;
+            next = (arenaBlock_t*)malloc(sizeof(arenaBlock_t) + newBlockSize);
+            if(next == NULL)
+                throw std::bad_alloc();
+            numBlocks++;
+            next->next = NULL;
+            next->size = newBlockSize;
+            if(currBlock == NULL)
+                firstBlock = next;
+            else
+                currBlock->next = next;
+        }
+        currBlock = next;
+        offset = 0;
+    }
+}
+
+/* hand out all blocks again from the start
+*/
+void ArenaClass::reset(void){
+    currBlock = firstBlock;
+    offset = 0;
+}
+
+size_t ArenaClass::getUsedBytes(void){
+    if(currBlock == NULL)
+        return 0;
+    size_t used = 0;
+    for(arenaBlock_t *block = firstBlock; block != currBlock; block = block->next)
+        used += block->size;
+    return used + offset;
+}
+
+int ArenaClass::getNumBlocks(void){
+    return numBlocks;
+}
@@ -4,24 +4,27 @@
 */
 /* step mode
 */
-volatile bool stepMode = true;
+std::atomic<bool> stepMode(true);
 /* This is set to true when the start and end goal cells
  * are set
 */
-volatile bool readyToStart = false;
+std::atomic<bool> readyToStart(false);
 /* this is set when the start cell is set, similar op
  * with endCellSet
 */
-volatile bool startCellSet = false;
-volatile bool endCellSet = false;
-/* mouse click position
+std::atomic<bool> startCellSet(false);
+std::atomic<bool> endCellSet(false);
+/* mouse click position, written before mouseClicked is set
 */
-double xPos, yPos;
+std::atomic<double> xPos(0), yPos(0);
 /* this is needed so that we operate only once in the loop.
  * Also, we compute cellX, cellY only if this boolean is 
  * set
 */
-volatile bool mouseClicked = false;
+std::atomic<bool> mouseClicked(false);
+/* mouse wheel movement not yet applied to the camera zoom
+*/
+std::atomic<double> scrollOffset(0);
 /* call back function that is registered to be called upon
  * mouse click
 */
\ No newline at end of file
@@ -0,0 +1,286 @@
+#include "../../Include/Utils/Log.h"
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+std::atomic<unsigned> logCategoryMask(~0u);
+
+namespace{
+    /* Bounded multi producer single consumer queue. Every slot has a
+     * sequence number, a producer claims a slot by moving head with a
+     * CAS and publishes it by bumping the slot sequence, the consumer
+     * only reads slots that were published. No producer ever waits on
+     * another. The writer sleeps while the queue is empty, the first
+     * producer to push after it went to sleep wakes it up
+    */
+    class LogWriterClass{
+        private:
+            static const size_t capacity = 1 << 14;
+            static const size_t mask = capacity - 1;
+            typedef struct{
+                std::atomic<size_t> seq;
+                logRecord_t record;
+            }slot_t;
+
+            slot_t *slots;
+            alignas(64) std::atomic<size_t> head;
+            alignas(64) std::atomic<size_t> tail;
+            /* number of messages that are on stdout, stored by the
+             * writer after each fflush
+            */
+            alignas(64) std::atomic<size_t> written;
+            std::atomic<long> dropped;
+            std::thread writer;
+            std::once_flag writerStarted;
+            std::atomic<bool> stopWriter;
+            /* set by the writer before it sleeps, the producer that
+             * clears it does the wake up
+            */
+            std::atomic<bool> writerWaiting;
+            std::mutex waitMtx;
+            std::condition_variable wakeCv;
+
+            bool isEmpty(void){
+                size_t t = tail.load(std::memory_order_relaxed);
+                return slots[t & mask].seq.load(std::memory_order_acquire) != t + 1;
+            }
+
+            /* the fences make sure that either the writer sees the new
+             * message before sleeping or the producer sees writerWaiting
+             * after publishing it
+            */
+            void waitForMessages(void){
+                std::unique_lock<std::mutex> lock(waitMtx);
+                writerWaiting.store(true, std::memory_order_relaxed);
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if(!isEmpty() || stopWriter.load(std::memory_order_acquire)){
+                    writerWaiting.store(false, std::memory_order_relaxed);
+                    return;
+                }
+                wakeCv.wait(lock, [this]{ return !writerWaiting.load(std::memory_order_relaxed); });
+            }
+
+            void wakeWriter(void){
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if(writerWaiting.load(std::memory_order_relaxed) && writerWaiting.exchange(false)){
+                    std::lock_guard<std::mutex> lock(waitMtx);
+                    wakeCv.notify_one();
+                }
+            }
+
+            bool pop(logRecord_t& record){
+                size_t t = tail.load(std::memory_order_relaxed);
+                slot_t *slot = &slots[t & mask];
+                if(slot->seq.load(std::memory_order_acquire) != t + 1)
+                    return false;
+                record = slot->record;
+                slot->seq.store(t + capacity, std::memory_order_release);
+                tail.store(t + 1, std::memory_order_release);
+                return true;
+            }
+
+            /* the lines are collected in a buffer and written with one
+             * call, stdout is only flushed once the queue is empty
+            */
+            void writerLoop(void){
+                static const size_t bufferSize = 1 << 16;
+                char *buffer = new char[bufferSize];
+                size_t used = 0;
+                size_t taken = 0;
+                logRecord_t record;
+                while(true){
+                    bool popped = pop(record);
+                    if(popped){
+                        taken++;
+                        if(used + logLineSize + 8 > bufferSize){
+                            fwrite(buffer, 1, used, stdout);
+                            used = 0;
+                        }
+                        if(record.level == LOG_LEVEL_WARN){
+                            memcpy(buffer + used, "[WARN] ", 7);
+                            used += 7;
+                        }
+                        memcpy(buffer + used, record.text, record.length);
+                        used += record.length;
+                        buffer[used++] = '\n';
+                        continue;
+                    }
+                    if(used != 0){
+                        fwrite(buffer, 1, used, stdout);
+                        fflush(stdout);
+                        used = 0;
+                        written.store(taken, std::memory_order_release);
+                    }
+                    if(stopWriter.load(std::memory_order_acquire) &&
+                    tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire))
+                        break;
+                    waitForMessages();
+                }
+                delete[] buffer;
+            }
+
+        public:
+            LogWriterClass(void){
+                slots = new slot_t[capacity];
+                for(size_t k = 0; k < capacity; k++)
+                    slots[k].seq.store(k, std::memory_order_relaxed);
+                head = 0;
+                tail = 0;
+                written = 0;
+                dropped = 0;
+                stopWriter = false;
+                writerWaiting = false;
+            }
+
+            /* whatever is still queued is written at exit, followed by
+             * the number of messages lost to a full queue
+            */
+            ~LogWriterClass(void){
+                {
+                    std::lock_guard<std::mutex> lock(waitMtx);
+                    stopWriter = true;
+                    writerWaiting = false;
+                }
+                wakeCv.notify_one();
+                if(writer.joinable())
+                    writer.join();
+                long numDropped = dropped.load(std::memory_order_relaxed);
+                if(numDropped != 0){
+                    fprintf(stdout, "[WARN] %ld log messages were dropped, the queue was full\n",
+                            numDropped);
+                    fflush(stdout);
+                }
+                delete[] slots;
+            }
+
+            void push(const logRecord_t& record){
+                /* the writer thread is only started by the first message,
+                 * so builds that log nothing never start it
+                */
+                std::call_once(writerStarted, [this]{
+                    writer = std::thread(&LogWriterClass::writerLoop, this);
+                });
+                size_t h = head.load(std::memory_order_relaxed);
+                slot_t *slot;
+                while(true){
+                    slot = &slots[h & mask];
+                    size_t seq = slot->seq.load(std::memory_order_acquire);
+                    long diff = (long)(seq - h);
+                    if(diff == 0){
+                        if(head.compare_exchange_weak(h, h + 1, std::memory_order_relaxed))
+                            break;
+                    }
+                    /* the slot still holds a message the writer has not
+                     * taken, the queue is full
+                    */
+                    else if(diff < 0){
+                        dropped.fetch_add(1, std::memory_order_relaxed);
+                        return;
+                    }
+                    else
+                        h = head.load(std::memory_order_relaxed);
+                }
+                slot->record = record;
+                slot->seq.store(h + 1, std::memory_order_release);
+                wakeWriter();
+            }
+
+            /* waits until every message pushed before the call has
+             * been written and flushed
+            */
+            void flush(void){
+                size_t h = head.load(std::memory_order_acquire);
+                while(written.load(std::memory_order_acquire) < h)
+                    std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+
+            long getDropped(void){
+                return dropped.load(std::memory_order_relaxed);
+            }
+    };
+
+    LogWriterClass logWriter;
+}
+
+void logSetCategories(unsigned mask){
+    logCategoryMask.store(mask, std::memory_order_relaxed);
+}
+
+void logFlush(void){
+    logWriter.flush();
+}
+
+long logGetDropped(void){
+    return logWriter.getDropped();
+}
+
+LogLineClass::LogLineClass(int level, logCategory category){
+    record.level = level;
+    record.category = category;
+    record.length = 0;
+}
+
+LogLineClass::~LogLineClass(void){
+    logWriter.push(record);
+}
+
+void LogLineClass::append(const char *str, int length){
+    if(length > logLineSize - record.length)
+        length = logLineSize - record.length;
+    memcpy(record.text + record.length, str, length);
+    record.length += length;
+}
+
+LogLineClass& LogLineClass::operator<<(const char *value){
+    append(value, strlen(value));
+    return *this;
+}
+
+LogLineClass& LogLineClass::operator<<(const std::string& value){
+    append(value.c_str(), value.size());
+    return *this;
+}
+
+LogLineClass& LogLineClass::operator<<(char value){
+    append(&value, 1);
+    return *this;
+}
+
+/* numbers are printed the way std::cout prints them by default
+*/
+LogLineClass& LogLineClass::operator<<(int value){
+    return *this<<(long long)value;
+}
+
+LogLineClass& LogLineClass::operator<<(unsigned int value){
+    return *this<<(unsigned long long)value;
+}
+
+LogLineClass& LogLineClass::operator<<(long value){
+    return *this<<(long long)value;
+}
+
+LogLineClass& LogLineClass::operator<<(unsigned long value){
+    return *this<<(unsigned long long)value;
+}
+
+LogLineClass& LogLineClass::operator<<(long long value){
+    char str[24];
+    append(str, snprintf(str, sizeof(str), "%lld", value));
+    return *this;
+}
+
+LogLineClass& LogLineClass::operator<<(unsigned long long value){
+    char str[24];
+    append(str, snprintf(str, sizeof(str), "%llu", value));
+    return *this;
+}
+
+LogLineClass& LogLineClass::operator<<(double value){
+    char str[32];
+    append(str, snprintf(str, sizeof(str), "%g", value));
+    return *this;
+}
@@ -0,0 +1,141 @@
+#include "../../Include/Utils/PerfCounters.h"
+#include "../../Include/Utils/Log.h"
+#include <atomic>
+#include <algorithm>
+#include <cstring>
+#include <cerrno>
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <sys/ioctl.h>
+#include <unistd.h>
+#endif
+
+namespace{
+    const char *eventNames[NUM_PERF_EVENTS] = {
+        "cycles", "instructions", "cache_misses", "branch_misses"
+    };
+
+    /* bit e is cleared once a thread could not open event e
+    */
+    std::atomic<unsigned int> availableEvents((1u << NUM_PERF_EVENTS) - 1);
+    std::atomic<bool> opened(false);
+    std::atomic<bool> warned(false);
+    std::atomic<bool> multiplexed(false);
+
+    void warnUnavailable(perfEvent event, int err){
+        availableEvents.fetch_and(~(1u << event));
+        if(!warned.exchange(true))
+            LOG_WARN(LOG_PLANNER, "Hardware counter "<<eventNames[event]<<" is unavailable ("
+                     <<strerror(err)<<"), the phases are timed without it");
+    }
+
+#ifdef __linux__
+    const uint64_t eventConfigs[NUM_PERF_EVENTS] = {
+        PERF_COUNT_HW_CPU_CYCLES, PERF_COUNT_HW_INSTRUCTIONS, PERF_COUNT_HW_CACHE_MISSES,
+        PERF_COUNT_HW_BRANCH_MISSES
+    };
+
+    /* the counters of a thread, in one group so that they are read with
+     * one system call. The first event that opens leads the group, only
+     * user space is counted so a perf_event_paranoid of 2 is enough
+    */
+    struct perfGroup_t{
+        int leader;
+        int fds[NUM_PERF_EVENTS];
+        /* events in the order a read returns them
+        */
+        int numOpen;
+        perfEvent order[NUM_PERF_EVENTS];
+        /* counts of the last read, in the same order
+        */
+        uint64_t last[NUM_PERF_EVENTS];
+
+        perfGroup_t(void){
+            leader = -1;
+            numOpen = 0;
+            for(int e = 0; e < NUM_PERF_EVENTS; e++)
+                last[e] = 0;
+            for(int e = 0; e < NUM_PERF_EVENTS; e++){
+                struct perf_event_attr attr;
+                memset(&attr, 0, sizeof(attr));
+                attr.size = sizeof(attr);
+                attr.type = PERF_TYPE_HARDWARE;
+                attr.config = eventConfigs[e];
+                attr.disabled = leader == -1 ? 1 : 0;
+                attr.exclude_kernel = 1;
+                attr.exclude_hv = 1;
+                attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_TOTAL_TIME_ENABLED |
+                PERF_FORMAT_TOTAL_TIME_RUNNING;
+                int fd = syscall(__NR_perf_event_open, &attr, 0, -1, leader, 0);
+                if(fd == -1){
+                    warnUnavailable((perfEvent)e, errno);
+                    continue;
+                }
+                if(leader == -1)
+                    leader = fd;
+                fds[numOpen] = fd;
+                order[numOpen++] = (perfEvent)e;
+            }
+            if(leader == -1)
+                return;
+            opened = true;
+            ioctl(leader, PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+            ioctl(leader, PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+        }
+        ~perfGroup_t(void){
+            for(int k = 0; k < numOpen; k++)
+                close(fds[k]);
+        }
+    };
+#endif
+}
+
+bool perfRead(uint64_t values[NUM_PERF_EVENTS]){
+    for(int e = 0; e < NUM_PERF_EVENTS; e++)
+        values[e] = 0;
+#ifdef __linux__
+    thread_local perfGroup_t group;
+    if(group.leader == -1)
+        return false;
+    /* the number of events, the time the group was enabled and the
+     * time it was running, followed by the counts
+    */
+    uint64_t data[3 + NUM_PERF_EVENTS];
+    bool valid = read(group.leader, data, sizeof(data)) >= 
+    (ssize_t)((3 + group.numOpen) * sizeof(uint64_t)) && data[2] != 0;
+    /* if there are more counters than the PMU has, the kernel takes
+     * turns and the group only counts part of the time. The counts are
+     * then scaled up to the whole time, and since such an estimate can
+     * go back a little a count never drops below the last one. A failed
+     * read repeats the last counts, so the differences stay valid
+    */
+    double scale = 1;
+    if(valid && data[2] < data[1]){
+        scale = (double)data[1]/data[2];
+        multiplexed = true;
+    }
+    for(int k = 0; k < group.numOpen; k++){
+        if(valid)
+            group.last[k] = std::max((uint64_t)(data[3 + k] * scale), group.last[k]);
+        values[group.order[k]] = group.last[k];
+    }
+    return true;
+#else
+    for(int e = 0; e < NUM_PERF_EVENTS; e++)
+        warnUnavailable((perfEvent)e, ENOSYS);
+    return false;
+#endif
+}
+
+bool perfIsMultiplexed(void){
+    return multiplexed;
+}
+
+bool perfIsEventAvailable(perfEvent event){
+    return opened && (availableEvents.load() & (1u << event)) != 0;
+}
+
+const char* perfGetEventName(perfEvent event){
+    return eventNames[event];
+}
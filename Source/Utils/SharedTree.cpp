@@ -0,0 +1,201 @@
+#include "../../Include/Utils/SharedTree.h"
+#include <iostream>
+#include <algorithm>
+#include <climits>
+#include <cmath>
+
+SharedTreeClass::SharedTreeClass(int _N, int _capacity, int _bucketDim){
+    N = _N;
+    capacity = _capacity;
+    bucketDim = _bucketDim;
+    numBuckets = (N + bucketDim - 1)/bucketDim;
+
+    nodes = new sharedNode_t[capacity];
+    for(int k = 0; k < capacity; k++){
+        nodes[k].parent.store(NULL, std::memory_order_relaxed);
+        nodes[k].next.store(NULL, std::memory_order_relaxed);
+        nodes[k].ready.store(false, std::memory_order_relaxed);
+    }
+    numReserved.store(0, std::memory_order_relaxed);
+
+    cellToNode = new std::atomic<int>[N * N];
+    for(int k = 0; k < N * N; k++)
+        cellToNode[k].store(EMPTY_CELL, std::memory_order_relaxed);
+
+    buckets = new std::atomic<sharedNode_t*>[numBuckets * numBuckets];
+    for(int k = 0; k < numBuckets * numBuckets; k++)
+        buckets[k].store(NULL, std::memory_order_relaxed);
+}
+
+SharedTreeClass::~SharedTreeClass(void){
+    delete[] nodes;
+    delete[] cellToNode;
+    delete[] buckets;
+}
+
+int SharedTreeClass::getIdx(int i, int j){
+    return (i + (j * N));
+}
+
+int SharedTreeClass::getBucketIdx(int bi, int bj){
+    return (bi + (bj * numBuckets));
+}
+
+float SharedTreeClass::getDistance(std::pair<int, int> a, std::pair<int, int> b){
+    return sqrt(pow((b.second - a.second), 2) + pow((b.first - a.first), 2));
+}
+
+/* add a node at cellPos connected to the node at parentIdx (-1 for the
+ * root), returns the slot of the new node or -1 if the cell already
+ * has a node or the tree is full. Safe to be called from multiple
+ * threads at once
+*/
+int SharedTreeClass::insertNode(std::pair<int, int> cellPos, int parentIdx){
+    int cellIdx = getIdx(cellPos.first, cellPos.second);
+    /* claim the cell, only one thread can win this
+    */
+    int expected = EMPTY_CELL;
+    if(!cellToNode[cellIdx].compare_exchange_strong(expected, CLAIMED_CELL,
+    std::memory_order_acq_rel))
+        return -1;
+
+    /* append into the preallocated array
+    */
+    int idx = numReserved.fetch_add(1, std::memory_order_relaxed);
+    if(idx >= capacity){
+        cellToNode[cellIdx].store(EMPTY_CELL, std::memory_order_release);
+        return -1;
+    }
+
+    sharedNode_t *node = &nodes[idx];
+    node->pos = cellPos;
+    node->parent.store(parentIdx < 0 ? NULL : &nodes[parentIdx], std::memory_order_release);
+    node->ready.store(true, std::memory_order_release);
+
+    /* publish to the nearest node index by pushing to the front of
+     * the bucket list
+    */
+    int b = getBucketIdx(cellPos.first/bucketDim, cellPos.second/bucketDim);
+    sharedNode_t *head = buckets[b].load(std::memory_order_relaxed);
+    do{
+        node->next.store(head, std::memory_order_relaxed);
+    }while(!buckets[b].compare_exchange_weak(head, node, std::memory_order_release,
+    std::memory_order_relaxed));
+
+    cellToNode[cellIdx].store(idx, std::memory_order_release);
+    return idx;
+}
+
+/* search the buckets in rings around the cell. Nodes in the next ring
+ * are at least r * bucketDim away, so we can stop as soon as the nearest
+ * node found so far is closer than that. Returns -1 if the tree is empty
+*/
+int SharedTreeClass::getNearestNode(std::pair<int, int> cellPos){
+    int bi = cellPos.first/bucketDim;
+    int bj = cellPos.second/bucketDim;
+
+    float minDistance = INT_MAX;
+    sharedNode_t *nearest = NULL;
+
+    for(int r = 0; r < numBuckets; r++){
+        for(int x = bi - r; x <= bi + r; x++){
+            for(int y = bj - r; y <= bj + r; y++){
+                /* only visit the perimeter of the ring
+                */
+                if(std::max(abs(x - bi), abs(y - bj)) != r)
+                    continue;
+                /* boundary guards
+                */
+                if(x < 0 || x > numBuckets-1 || y < 0 || y > numBuckets-1)
+                    continue;
+
+                sharedNode_t *node = buckets[getBucketIdx(x, y)].load(std::memory_order_acquire);
+                while(node != NULL){
+                    float d = getDistance(cellPos, node->pos);
+                    if(d < minDistance){
+                        minDistance = d;
+                        nearest = node;
+                    }
+                    node = node->next.load(std::memory_order_acquire);
+                }
+            }
+        }
+        if(nearest != NULL && minDistance <= r * bucketDim)
+            break;
+    }
+    return nearest == NULL ? -1 : getNodeIdx(nearest);
+}
+
+int SharedTreeClass::getNodeIdx(sharedNode_t* node){
+    return node == NULL ? -1 : (int)(node - nodes);
+}
+
+int SharedTreeClass::getNumReserved(void){
+    return std::min(numReserved.load(std::memory_order_acquire), capacity);
+}
+
+bool SharedTreeClass::isNodeReady(int idx){
+    return nodes[idx].ready.load(std::memory_order_acquire);
+}
+
+/* NOTE: only call these on a node that is ready
+*/
+std::pair<int, int> SharedTreeClass::getNodePos(int idx){
+    return nodes[idx].pos;
+}
+
+int SharedTreeClass::getParentIdx(int idx){
+    return getNodeIdx(nodes[idx].parent.load(std::memory_order_acquire));
+}
+
+/* check the tree after all writers have stopped: every node is ready
+ * and owns its cell, only the root has no parent, a parent always sits
+ * at a lower slot (so there are no cycles) and every node is in exactly
+ * one bucket, the one that covers its cell
+*/
+bool SharedTreeClass::verifyIntegrity(void){
+    int numNodes = getNumReserved();
+    std::vector<int> bucketCount(numNodes, 0);
+
+    for(int k = 0; k < numNodes; k++){
+        if(!isNodeReady(k)){
+            std::cout<<"[ERROR] Shared tree node "<<k<<" not ready"<<std::endl;
+            return false;
+        }
+        std::pair<int, int> pos = getNodePos(k);
+        if(cellToNode[getIdx(pos.first, pos.second)].load() != k){
+            std::cout<<"[ERROR] Shared tree node "<<k<<" does not own its cell"<<std::endl;
+            return false;
+        }
+        int parentIdx = getParentIdx(k);
+        if((k == 0 && parentIdx != -1) || (k != 0 && (parentIdx < 0 || parentIdx >= k))){
+            std::cout<<"[ERROR] Shared tree node "<<k<<" has invalid parent "
+                     <<parentIdx<<std::endl;
+            return false;
+        }
+    }
+
+    for(int bj = 0; bj < numBuckets; bj++){
+        for(int bi = 0; bi < numBuckets; bi++){
+            sharedNode_t *node = buckets[getBucketIdx(bi, bj)].load();
+            while(node != NULL){
+                int k = getNodeIdx(node);
+                if(k < 0 || k >= numNodes || node->pos.first/bucketDim != bi ||
+                node->pos.second/bucketDim != bj){
+                    std::cout<<"[ERROR] Shared tree node "<<k<<" in wrong bucket"<<std::endl;
+                    return false;
+                }
+                bucketCount[k]++;
+                node = node->next.load();
+            }
+        }
+    }
+    for(int k = 0; k < numNodes; k++){
+        if(bucketCount[k] != 1){
+            std::cout<<"[ERROR] Shared tree node "<<k<<" found in "<<bucketCount[k]
+                     <<" buckets"<<std::endl;
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,198 @@
+#include "../../Include/Utils/Stats.h"
+#include "../../Include/Utils/Alloc.h"
+#include "../../Include/Utils/Log.h"
+#include <fstream>
+#include <vector>
+#include <mutex>
+#include <algorithm>
+
+namespace{
+    const char *phaseNames[NUM_PHASES] = {
+        "sample", "nearest", "steer", "collision", "parent", "rewire", "path", "color",
+        "upload"
+    };
+    const char *counterNames[NUM_COUNTERS] = {
+        "iterations", "samples_rejected", "node_exists", "invalid_node", "reroutes",
+        "nodes_added", "allocations", "allocated_bytes"
+    };
+
+    /* blocks of the running threads and the total of the exited ones
+    */
+    std::mutex blocksMtx;
+    std::vector<statsBlock_t*> blocks;
+    statsBlock_t retired;
+
+    void clearBlock(statsBlock_t *block){
+        for(int k = 0; k < NUM_PHASES; k++){
+            block->phaseTime[k] = 0;
+            block->phaseCalls[k] = 0;
+            for(int e = 0; e < NUM_PERF_EVENTS; e++)
+                block->phaseEvents[k][e] = 0;
+        }
+        for(int k = 0; k < NUM_COUNTERS; k++)
+            block->counters[k] = 0;
+    }
+
+    void addBlock(statsSnapshot_t& sum, statsBlock_t *block){
+        for(int k = 0; k < NUM_PHASES; k++){
+            sum.phaseTime[k] += block->phaseTime[k].load(std::memory_order_relaxed);
+            sum.phaseCalls[k] += block->phaseCalls[k].load(std::memory_order_relaxed);
+            for(int e = 0; e < NUM_PERF_EVENTS; e++)
+                sum.phaseEvents[k][e] += block->phaseEvents[k][e].load(std::memory_order_relaxed);
+        }
+        for(int k = 0; k < NUM_COUNTERS; k++)
+            sum.counters[k] += block->counters[k].load(std::memory_order_relaxed);
+    }
+
+    /* owns the block of a thread, registers it on first use and folds
+     * it into the retired total when the thread exits
+    */
+    struct blockOwner_t{
+        statsBlock_t *block;
+
+        blockOwner_t(void){
+            block = new statsBlock_t;
+            clearBlock(block);
+            std::lock_guard<std::mutex> lock(blocksMtx);
+            blocks.push_back(block);
+        }
+        ~blockOwner_t(void){
+            std::lock_guard<std::mutex> lock(blocksMtx);
+            for(int k = 0; k < NUM_PHASES; k++){
+                statsAdd(retired.phaseTime[k], block->phaseTime[k]);
+                statsAdd(retired.phaseCalls[k], block->phaseCalls[k]);
+                for(int e = 0; e < NUM_PERF_EVENTS; e++)
+                    statsAdd(retired.phaseEvents[k][e], block->phaseEvents[k][e]);
+            }
+            for(int k = 0; k < NUM_COUNTERS; k++)
+                statsAdd(retired.counters[k], block->counters[k]);
+            blocks.erase(std::find(blocks.begin(), blocks.end(), block));
+            delete block;
+        }
+    };
+
+    /* innermost running timer of the thread
+    */
+    thread_local PhaseTimerClass *currentTimer = NULL;
+}
+
+statsBlock_t* statsGetBlock(void){
+    thread_local blockOwner_t owner;
+    return owner.block;
+}
+
+PhaseTimerClass::PhaseTimerClass(statsPhase _phase){
+    phase = _phase;
+    running = true;
+    childTime = 0;
+    parent = currentTimer;
+    currentTimer = this;
+    start = std::chrono::steady_clock::now();
+#if PERF_COUNTERS == 1
+    for(int e = 0; e < NUM_PERF_EVENTS; e++)
+        childEvents[e] = 0;
+    perfRead(startEvents);
+#endif
+}
+
+PhaseTimerClass::~PhaseTimerClass(void){
+    stop();
+}
+
+void PhaseTimerClass::stop(void){
+    if(!running)
+        return;
+    running = false;
+#if PERF_COUNTERS == 1
+    uint64_t events[NUM_PERF_EVENTS];
+    perfRead(events);
+#endif
+    uint64_t elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - start).count();
+    statsBlock_t *block = statsGetBlock();
+#if PERF_COUNTERS == 1
+    for(int e = 0; e < NUM_PERF_EVENTS; e++){
+        uint64_t count = events[e] - startEvents[e];
+        statsAdd(block->phaseEvents[phase][e], count - std::min(childEvents[e], count));
+        if(parent != NULL)
+            parent->childEvents[e] += count;
+    }
+#endif
+    statsAdd(block->phaseTime[phase], elapsed - std::min(childTime, elapsed));
+    statsAdd(block->phaseCalls[phase], 1);
+    if(parent != NULL)
+        parent->childTime += elapsed;
+    currentTimer = parent;
+}
+
+statsSnapshot_t statsGetSnapshot(void){
+    statsSnapshot_t sum = {};
+    std::lock_guard<std::mutex> lock(blocksMtx);
+    addBlock(sum, &retired);
+    for(int k = 0; k < blocks.size(); k++)
+        addBlock(sum, blocks[k]);
+    return sum;
+}
+
+/* meant to be called while no phase is being timed, for example
+ * between runs
+*/
+void statsReset(void){
+    std::lock_guard<std::mutex> lock(blocksMtx);
+    clearBlock(&retired);
+    for(int k = 0; k < blocks.size(); k++)
+        clearBlock(blocks[k]);
+}
+
+const char* statsGetPhaseName(statsPhase phase){
+    return phaseNames[phase];
+}
+
+const char* statsGetCounterName(statsCounter counter){
+    return counterNames[counter];
+}
+
+bool statsWriteJSON(const std::string& fileName){
+    std::ofstream file(fileName);
+    if(!file){
+        LOG_WARN(LOG_PROFILE, "Could not open "<<fileName);
+        return false;
+    }
+    statsSnapshot_t stats = statsGetSnapshot();
+    file<<"{\n  \"phases\": {\n";
+    for(int k = 0; k < NUM_PHASES; k++){
+        uint64_t calls = stats.phaseCalls[k];
+        file<<"    \""<<phaseNames[k]<<"\": {\"calls\": "<<calls<<", \"total_ns\": "
+            <<stats.phaseTime[k]<<", \"mean_ns\": "<<(calls == 0 ? 0 : stats.phaseTime[k]/calls);
+        /* only the events that could be counted by every thread
+        */
+        for(int e = 0; e < NUM_PERF_EVENTS && PERF_COUNTERS == 1; e++){
+            if(perfIsEventAvailable((perfEvent)e))
+                file<<", \""<<perfGetEventName((perfEvent)e)<<"\": "<<stats.phaseEvents[k][e];
+        }
+        if(PERF_COUNTERS == 1 && perfIsEventAvailable(PERF_CYCLES) &&
+           perfIsEventAvailable(PERF_INSTRUCTIONS) && stats.phaseEvents[k][PERF_CYCLES] != 0)
+            file<<", \"ipc\": "<<(double)stats.phaseEvents[k][PERF_INSTRUCTIONS]/
+                  stats.phaseEvents[k][PERF_CYCLES];
+        file<<"}"<<(k == NUM_PHASES - 1 ? "\n" : ",\n");
+    }
+    file<<"  },\n  \"counters\": {\n";
+    /* the allocation counters are left out if they were not counted
+    */
+    int numCounters = ALLOC_TRACKING == 1 ? NUM_COUNTERS : COUNT_ALLOCATIONS;
+    for(int k = 0; k < numCounters; k++)
+        file<<"    \""<<counterNames[k]<<"\": "<<stats.counters[k]
+            <<(k == numCounters - 1 ? "\n" : ",\n");
+    file<<"  }";
+    if(ALLOC_TRACKING == 1){
+        uint64_t iterations = stats.counters[COUNT_ITERATIONS];
+        file<<",\n  \"allocations_per_iteration\": "<<(iterations == 0 ? 0.0 :
+              (double)stats.counters[COUNT_ALLOCATIONS]/iterations);
+    }
+    /* the event counts are estimates if they were scaled
+    */
+    if(PERF_COUNTERS == 1)
+        file<<",\n  \"perf_scaled\": "<<(perfIsMultiplexed() ? "true" : "false");
+    file<<"\n}\n";
+    return file.good();
+}
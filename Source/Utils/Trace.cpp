@@ -0,0 +1,191 @@
+#include "../../Include/Utils/Trace.h"
+#include "../../Include/Utils/Log.h"
+#include <fstream>
+#include <vector>
+#include <mutex>
+#include <chrono>
+#include <cstdio>
+#include <stdlib.h>
+
+std::atomic<bool> traceActive(false);
+
+namespace{
+    /* spans are kept in chunks so a buffer never moves while it is
+     * written, a thread keeps at most maxEvents spans and drops the rest
+    */
+    static const int chunkSize = 1 << 12;
+    static const long maxEvents = 1 << 20;
+
+    typedef struct chunk_t{
+        traceEvent_t events[chunkSize];
+        std::atomic<int> count;
+        std::atomic<chunk_t*> next;
+    }chunk_t;
+
+    /* Only the owning thread writes to a buffer. A span is filled in
+     * before the chunk count is bumped, so a reader that sees the count
+     * sees the span. Buffers outlive their thread, the spans are written
+     * out at exit
+    */
+    typedef struct{
+        int tid;
+        std::atomic<const char*> name;
+        std::atomic<chunk_t*> first;
+        chunk_t *last;
+        long numEvents;
+        std::atomic<long> dropped;
+    }threadBuffer_t;
+
+    class TraceRegistryClass{
+        public:
+            std::mutex mtx;
+            std::vector<threadBuffer_t*> buffers;
+
+            ~TraceRegistryClass(void){
+                for(int k = 0; k < buffers.size(); k++){
+                    chunk_t *chunk = buffers[k]->first.load();
+                    while(chunk != NULL){
+                        chunk_t *next = chunk->next.load();
+                        free(chunk);
+                        chunk = next;
+                    }
+                    delete buffers[k];
+                }
+            }
+    };
+
+    TraceRegistryClass registry;
+    const std::chrono::steady_clock::time_point epoch = std::chrono::steady_clock::now();
+    thread_local threadBuffer_t *localBuffer = NULL;
+
+    threadBuffer_t* getLocalBuffer(void){
+        if(localBuffer == NULL){
+            threadBuffer_t *buffer = new threadBuffer_t;
+            buffer->name = NULL;
+            buffer->first = NULL;
+            buffer->last = NULL;
+            buffer->numEvents = 0;
+            buffer->dropped = 0;
+            std::lock_guard<std::mutex> lock(registry.mtx);
+            buffer->tid = registry.buffers.size() + 1;
+            registry.buffers.push_back(buffer);
+            localBuffer = buffer;
+        }
+        return localBuffer;
+    }
+
+    /* the chunks are taken with malloc, so they do not show up in the
+     * allocation counts of the traced code
+    */
+    chunk_t* newChunk(void){
+        chunk_t *chunk = (chunk_t*)malloc(sizeof(chunk_t));
+        chunk->count.store(0, std::memory_order_relaxed);
+        chunk->next.store(NULL, std::memory_order_relaxed);
+        return chunk;
+    }
+}
+
+void traceStart(void){
+    traceActive.store(true, std::memory_order_relaxed);
+}
+
+void traceStop(void){
+    traceActive.store(false, std::memory_order_relaxed);
+}
+
+void traceSetThreadName(const char *name){
+    getLocalBuffer()->name.store(name, std::memory_order_release);
+}
+
+uint64_t traceNow(void){
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+    std::chrono::steady_clock::now() - epoch).count();
+}
+
+void traceRecord(const char *name, uint64_t start, uint64_t end){
+    threadBuffer_t *buffer = getLocalBuffer();
+    if(buffer->numEvents == maxEvents){
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+    chunk_t *chunk = buffer->last;
+    int count = chunk == NULL ? chunkSize : chunk->count.load(std::memory_order_relaxed);
+    if(count == chunkSize){
+        chunk_t *next = newChunk();
+        if(chunk == NULL)
+            buffer->first.store(next, std::memory_order_release);
+        else
+            chunk->next.store(next, std::memory_order_release);
+        buffer->last = next;
+        chunk = next;
+        count = 0;
+    }
+    traceEvent_t *event = &chunk->events[count];
+    event->name = name;
+    event->start = start;
+    event->duration = end - start;
+    chunk->count.store(count + 1, std::memory_order_release);
+    buffer->numEvents++;
+}
+
+long traceGetDropped(void){
+    long dropped = 0;
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    for(int k = 0; k < registry.buffers.size(); k++)
+        dropped += registry.buffers[k]->dropped.load(std::memory_order_relaxed);
+    return dropped;
+}
+
+/* complete events ("ph":"X") with the times in microseconds, one
+ * thread_name metadata event per named thread
+*/
+bool traceWriteJSON(const std::string& fileName){
+    std::lock_guard<std::mutex> lock(registry.mtx);
+    long numEvents = 0, dropped = 0;
+    for(int k = 0; k < registry.buffers.size(); k++){
+        chunk_t *chunk = registry.buffers[k]->first.load(std::memory_order_acquire);
+        for(; chunk != NULL; chunk = chunk->next.load(std::memory_order_acquire))
+            numEvents += chunk->count.load(std::memory_order_acquire);
+        dropped += registry.buffers[k]->dropped.load(std::memory_order_relaxed);
+    }
+    if(numEvents == 0)
+        return false;
+
+    std::ofstream file(fileName);
+    if(!file){
+        LOG_WARN(LOG_PROFILE, "Could not open "<<fileName);
+        return false;
+    }
+    char line[256];
+    bool firstLine = true;
+    file<<"{\"displayTimeUnit\": \"ms\", \"traceEvents\": [\n";
+    for(int k = 0; k < registry.buffers.size(); k++){
+        threadBuffer_t *buffer = registry.buffers[k];
+        const char *name = buffer->name.load(std::memory_order_acquire);
+        if(name != NULL){
+            snprintf(line, sizeof(line), "%s{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 1, "
+            "\"tid\": %d, \"args\": {\"name\": \"%s\"}}", firstLine ? "" : ",\n", buffer->tid, name);
+            file<<line;
+            firstLine = false;
+        }
+        chunk_t *chunk = buffer->first.load(std::memory_order_acquire);
+        for(; chunk != NULL; chunk = chunk->next.load(std::memory_order_acquire)){
+            int count = chunk->count.load(std::memory_order_acquire);
+            for(int i = 0; i < count; i++){
+                traceEvent_t *event = &chunk->events[i];
+                snprintf(line, sizeof(line), "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, "
+                "\"tid\": %d, \"ts\": %.3f, \"dur\": %.3f}", firstLine ? "" : ",\n", event->name,
+                buffer->tid, event->start/1000.0, event->duration/1000.0);
+                file<<line;
+                firstLine = false;
+            }
+        }
+    }
+    file<<"\n]}\n";
+    if(dropped != 0)
+        LOG_INFO(LOG_PROFILE, "Trace: "<<numEvents<<" spans written to "<<fileName<<" ("
+                 <<dropped<<" dropped)");
+    else
+        LOG_INFO(LOG_PROFILE, "Trace: "<<numEvents<<" spans written to "<<fileName);
+    return file.good();
+}
@@ -1,17 +1,24 @@
 #include "../../Include/Utils/Tree.h"
+#include "../../Include/Utils/Stats.h"
 #include <stdlib.h>
 #include <iostream>
 #include <cmath>
+#include <cassert>
 
-TreeClass::TreeClass(void){
+TreeClass::TreeClass(ArenaClass *_arena): 
+ownedArena(_arena == NULL ? new ArenaClass(arenaBlockSize) : NULL),
+arena(_arena == NULL ? ownedArena : _arena),
+mp(std::less<std::pair<int, int>>(), arenaAllocator<std::pair<const std::pair<int, int>, node_t*>>(arena)){
     root = NULL;
 }
 
 TreeClass::~TreeClass(void){
-    /* free all nodes
+    /* the map entries live in the arena, so the map is emptied before
+     * the arena goes away. Memory of a given arena is given back by
+     * its owner
     */
-    for(auto it = mp.begin(); it != mp.end(); it++)
-        free(it->second);
+    mp.clear();
+    delete ownedArena;
 }
 
 /* (i,j) -|- mode_t* are the map contents
@@ -34,8 +41,12 @@ node_t* TreeClass::getNodeFromCell(int i, int j){
 
 /* get all node positions starting from lastAddedNode to start cell
 */
-std::vector<std::pair<int, int>> TreeClass::getPath(std::pair<int, int> lastAddedNode){
-    std::vector<std::pair<int, int>> solvedPath;
+void TreeClass::getPath(std::pair<int, int> lastAddedNode, std::vector<std::pair<int, int>>& solvedPath){
+    STATS_PHASE(timer, PHASE_PATH);
+    /* the vector is reused, it only grows if the path is longer than
+     * any path it held before
+    */
+    solvedPath.clear();
     node_t *currNode = getNodeFromCell(lastAddedNode.first, lastAddedNode.second);
     if(currNode == NULL)
         assert(false);
@@ -45,29 +56,33 @@ std::vector<std::pair<int, int>> TreeClass::getPath(std::pair<int, int> lastAdde
         currNode = currNode->parent;
         solvedPath.push_back(currNode->pos);
     }
-    return solvedPath;
+}
+
+int TreeClass::getNumNodes(void){
+    return mp.size();
+}
+
+int TreeClass::getNumArenaBlocks(void){
+    return arena->getNumBlocks();
 }
 
 bool TreeClass::createNode(std::pair<int, int> cellPos){
-    node_t *newNode = (node_t*)malloc(sizeof(node_t));
+    /* update map to help in retreiving the node using cell
+     * coordinates or freeing up node memory, there can be only
+     * one node per cell
+    */
+    if(mp.find(cellPos) != mp.end())
+        return false;
+
+    node_t *newNode = (node_t*)arena->allocate(sizeof(node_t), alignof(node_t));
     newNode->pos = cellPos;
     newNode->parent = NULL;
 
     if(root == NULL){
         root = newNode;
     }
-
-    /* update map to help in retreiving the node using cell
-     * coordinates or freeing up node memory
-    */
-    if(mp.find(cellPos) == mp.end()){
-        mp[cellPos] = newNode;
-        return true;
-    }
-    else{
-        free(newNode);
-        return false;
-    }
+    mp[cellPos] = newNode;
+    return true;
 }
 
 /* NOTE: source will be the parent and dest will be a child
@@ -111,4 +126,10 @@ float TreeClass::getDistanceToRoot(node_t* dest){
     return d;
 }
 
-
+float getPathCost(const std::vector<std::pair<int, int>>& path){
+    float cost = 0;
+    for(int k = 1; k < path.size(); k++)
+        cost += sqrt(pow((path[k].second - path[k-1].second), 2) +
+                     pow((path[k].first - path[k-1].first), 2));
+    return cost;
+}
@@ -1,22 +1,39 @@
 #include "../../../Include/Visualization/Grid/Grid.h"
 #include "../../../Include/Visualization/Shader/Shader.h"
 #include "../../../Include/Utils/Common.h"
+#include "../../../Include/Utils/Log.h"
+#include "../../../Include/Utils/Stats.h"
+#include "../../../Include/Utils/Trace.h"
 #include <iostream>
 #include <stdlib.h>
+#include <string.h>
 #include <cassert>
+#include <chrono>
+#include <algorithm>
+#include <cmath>
 
 void mouse_button_callback(GLFWwindow* window, int button, int action, int mods){
     if(button == GLFW_MOUSE_BUTTON_LEFT && action == GLFW_PRESS) {
-        /* getting cursor position
+        /* getting cursor position, the position has to be stored
+         * before mouseClicked is set since the simulation thread 
+         * reads it once it sees mouseClicked
         */
-        glfwGetCursorPos(window, &xPos, &yPos);
+        double x, y;
+        glfwGetCursorPos(window, &x, &y);
+        xPos = x;
+        yPos = y;
         mouseClicked = true;
-#if 0
-    std::cout<<"xPos: "<<xPos<<" yPos: "<<yPos<<std::endl;
-#endif
+        LOG_DEBUG(LOG_INPUT, "xPos: "<<x<<" yPos: "<<y);
     }
 }
 
+/* mouse wheel zooms the camera, the offset is applied by the render
+ * thread in processInput
+*/
+void scroll_callback(GLFWwindow*, double, double yoffset){
+    scrollOffset = scrollOffset + yoffset;
+}
+
 /* this function will be called in the mouse action callback
  * function that is registered. the output of this funtion is
  * the cell position at which the mouse is clicked
@@ -30,48 +47,63 @@ void mouse_button_callback(GLFWwindow* window, int button, int action, int mods)
  * Y axis
  * 
  * What we need is to convert xPos and yPos to grid cell
- * coordinates, and set them to cellX, cellY.
+ * coordinates, and set them to cellX, cellY. The window shows
+ * the part of the grid under the camera, viewSize cells across
+ * starting at (viewX, viewY) at the lower left. The grid is drawn
+ * with cell (i,j) at column i and row j counted from the bottom,
+ * so cellX comes from the horizontal position and cellY from the
+ * vertical one.
  * 
- * NOTE: If the scale changes (by resizing the window while
+ * NOTE: If the window size changes (by resizing the window while
  * running) then this functino fails to find the right cell
  * coords. Here, we have disabled window resizing.
 */
 void GridClass::mouseAction(double mouseXPos, double mouseYPos){
-    /* First we remove the scale factor from the position
-     * returned. Next, xPos remains the same (based on the
-     * above figure), but rate of change of yPos has to be
-     * inverted
-    */
-    mouseXPos = mouseXPos/scale;
-    mouseYPos = N - (mouseYPos/scale);
-    /* compute grid cell position
-    */
-    cellX = (int)mouseXPos;
-    cellY = (int)mouseYPos;
-#if 0
-    std::cout<<"cellX: "<<cellX<<" cellY: "<<cellY<<std::endl;
-#endif
+    /* First we convert the position to a fraction of the window,
+     * xPos remains the same (based on the above figure), but rate
+     * of change of yPos has to be inverted
+    */
+    double size = viewSize.load();
+    double gridX = viewX.load() + (mouseXPos/windowDim) * size;
+    double gridY = viewY.load() + ((windowDim - mouseYPos)/windowDim) * size;
+    /* compute grid cell position, a click outside the grid picks
+     * the nearest cell on the border
+    */
+    cellX = std::min(std::max((int)floor(gridX), 0), N - 1);
+    cellY = std::min(std::max((int)floor(gridY), 0), N - 1);
+    LOG_DEBUG(LOG_INPUT, "cellX: "<<cellX<<" cellY: "<<cellY);
 }
 
 GridClass::GridClass(int _N, int _scale, bool noStroke){
-    axisMin = -1.0;
-    axisMax = 1.0;
-    N = _N;
+    initParams(_N, _scale);
     assert(N % 2 == 0);
 
-    scale = _scale;
-    cellDim = (axisMax - axisMin)/N;
-    
-    /* init predefined color vals
+    cellStates = (unsigned char*)malloc(sizeof(unsigned char) * N * N);
+    /* the window fits the whole grid at the given scale if it can,
+     * the texture holds at most a window worth of texels (plus the 
+     * partly visible ones at the borders)
     */
-    redVal.R = 1.0;    redVal.G = 0.0;    redVal.B = 0.0;
-    greenVal.R = 0.0;  greenVal.G = 1.0;  greenVal.B = 0.0;
-    blueVal.R = 0.0,   blueVal.G = 0.0;   blueVal.B = 1.0;
-    blackVal.R = 0.0;  blackVal.G = 0.0;  blackVal.B = 0.0;
-    whiteVal.R = 1.0;  whiteVal.G = 1.0;  whiteVal.B = 1.0;
-
-    colorArraySize = 16 * N * N;
-    color = (float*)malloc(sizeof(float) * colorArraySize);
+    windowDim = std::min(N * scale, maxWindowDim);
+    textureDim = windowDim + 2;
+    /* level of detail pyramid, down to the level that fits in the
+     * window
+    */
+    levels.push_back(cellStates);
+    levelDims.push_back(N);
+    while(levelDims.back() > windowDim){
+        int dim = (levelDims.back() + 1)/2;
+        levels.push_back((unsigned char*)malloc(sizeof(unsigned char) * dim * dim));
+        levelDims.push_back(dim);
+    }
+    viewChanged = true;
+    paletteDirty = true;
+    /* the whole texture is uploaded the first time
+    */
+    dirtySpanMin.assign(N, 0);
+    dirtySpanMax.assign(N, N - 1);
+    dirtyRowMin = 0;
+    dirtyRowMax = N - 1;
+    stroke = !noStroke;
 
     /* opengl brinup routine
     */
@@ -81,17 +113,14 @@ GridClass::GridClass(int _N, int _scale, bool noStroke){
         assert(false);
     }
 
-    /* create all vertices for all grid cells
+    /* set all cells to white, white is the first palette entry so
+     * this is a memset and startup does not depend on N
     */
-    for(int i = 0; i < N; i++){
-        for(int j = 0; j < N; j++){
-            genCellVerticesWrapper(i, j);
-            genCellColor(i, j, whiteVal, 1.0);
-        }
-    }
+    unsigned char white = getPaletteIdx(whiteVal, 1.0);
+    for(int k = 0; k < levels.size(); k++)
+        memset(levels[k], white, sizeof(unsigned char) * levelDims[k] * levelDims[k]);
     /* move data to gpu
     */
-    moveDataToGPU(VERTEX);
     moveDataToGPU(COLOR);
 
     /* Right now we sent the input vertex data to the GPU 
@@ -110,8 +139,8 @@ GridClass::GridClass(int _N, int _scale, bool noStroke){
      * This means we have to specify how OpenGL should 
      * interpret the vertex data before rendering.
     */
-    setVertexAttribute(VERTEX);
-    setVertexAttribute(COLOR);
+    setVertexAttribute(EDGE);
+    setVertexAttribute(PATH);
     /* We need this to enable alpha transperancy of our cells.
      * The glBlendFunc(GLenum sfactor, GLenum dfactor) function 
      * expects two parameters that set the option for the source 
@@ -119,24 +148,104 @@ GridClass::GridClass(int _N, int _scale, bool noStroke){
     */
     glEnable(GL_BLEND);
     glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
-    /* enable/disable wireframe mode
+}
+
+GridClass::GridClass(int _N){
+    initParams(_N, 1);
+}
+
+/* the state of a grid without a window, the windowed constructor then
+ * allocates the cells and marks everything for upload
+*/
+void GridClass::initParams(int _N, int _scale){
+    startTime = std::chrono::steady_clock::now();
+    axisMin = -1.0;
+    axisMax = 1.0;
+    N = _N;
+    scale = _scale;
+    cellDim = (axisMax - axisMin)/N;
+    
+    /* init predefined color vals
+    */
+    redVal.R = 1.0;    redVal.G = 0.0;    redVal.B = 0.0;
+    greenVal.R = 0.0;  greenVal.G = 1.0;  greenVal.B = 0.0;
+    blueVal.R = 0.0,   blueVal.G = 0.0;   blueVal.B = 1.0;
+    blackVal.R = 0.0;  blackVal.G = 0.0;  blackVal.B = 0.0;
+    whiteVal.R = 1.0;  whiteVal.G = 1.0;  whiteVal.B = 1.0;
+
+    cellStates = NULL;
+    windowDim = 0;
+    textureDim = 0;
+    /* start with the whole grid in view
     */
-    if(noStroke)
-        glPolygonMode(GL_FRONT_AND_BACK, GL_FILL);
-    else
-        glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+    viewX = 0;
+    viewY = 0;
+    viewSize = N;
+    viewChanged = false;
+    viewLevel = -1;
+    viewTexX = 0;   viewTexY = 0;
+    viewTexW = 0;   viewTexH = 0;
+    paletteSize = 0;
+    lastPaletteIdx = 0;
+    paletteDirty = false;
+    dirtyRowMin = 0;
+    dirtyRowMax = -1;
+    frameUploadBytes = 0;
+    totalUploadBytes = 0;
+    edgeDirtyMin = 0;
+    edgeDirtyMax = -1;
+    edgeBufferCapacity = 0;
+    pathDirty = false;
+    edgeColor = blueVal;    edgeAlpha = 1.0;
+    pathColor = redVal;     pathAlpha = 1.0;
+    pathWidth = 0;
+    stroke = false;
+    window = NULL;
+
+    simulationThreaded = false;
+    cellUpdates = NULL;
+    lineUpdates = NULL;
+    frameBudget = 0;
+    iterationCost = 0;
+    lastFrameTime = 0;
+    avgFrameTime = 0;
+    numFrames = 0;
+    stepKeyDown = false;
+    frameDirty = true;
+    renderWaiting = false;
+    idleWaitTime = 0.5;
+    captureRequested = false;
+    capturing = false;
+    captureKeyDown = false;
+    traceKeyDown = false;
+    capturePrefix = "capture";
+    captureFmt = CAPTURE_PPM;
+    captureQueue = NULL;
+    captureDone = NULL;
+    captureFrameId = 0;
+    captureDropped = 0;
+    captureStalls = 0;
+    captureFrameTime = 0;
+    numCaptureFrames = 0;
 }
 
 GridClass::~GridClass(void){
-    free(color);
-    openGLClose();
+    /* level 0 is cellStates
+    */
+    for(int k = 1; k < levels.size(); k++)
+        free(levels[k]);
+    free(cellStates);
+    delete cellUpdates;
+    delete lineUpdates;
+    if(window != NULL)
+        openGLClose();
 }
 
 GLFWwindow* GridClass::openGLBringUp(void){
     /* Total screen space
     */
-    const unsigned int screenWidth = N * scale;
-    const unsigned int screenHeight = N * scale;
+    const unsigned int screenWidth = windowDim;
+    const unsigned int screenHeight = windowDim;
     /* main render window title
     */
     const char* windowTitle = "PATH FINDING";
@@ -204,6 +313,7 @@ GLFWwindow* GridClass::openGLBringUp(void){
      * on every mouse click
     */
     glfwSetMouseButtonCallback(window, mouse_button_callback);
+    glfwSetScrollCallback(window, scroll_callback);
 
     /* GLAD manages function pointers for OpenGL so we want 
      * to initialize GLAD before we call any OpenGL function.
@@ -250,123 +360,260 @@ void GridClass::genBufferObjects(void){
      * the object and that is it.
     */
     glGenVertexArrays(1, &VAO);
-    /* A vertex buffer object is an OpenGL object. Just like 
+    /* The cell states texture, unsigned bytes. GL_R8UI is an
+     * integer format, the shader reads back the exact palette index,
+     * and integer textures must use GL_NEAREST filtering. The storage
+     * is allocated once here and is the size of the window, not the
+     * grid. Later uploads only replace parts of it
+    */
+    glGenTextures(1, &textureCells);
+    glBindTexture(GL_TEXTURE_2D, textureCells);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_R8UI, textureDim, textureDim, 0, GL_RED_INTEGER, 
+                 GL_UNSIGNED_BYTE, NULL);
+    /* line overlay, the buffers are sized when the first lines show up
+     *
+     * A vertex buffer object is an OpenGL object. Just like 
      * any object in OpenGL, this buffer has a unique ID 
      * corresponding to thatbuffer, so we can generate one 
      * with a buffer ID using the glGenBuffers function. 
     */
-    glGenBuffers(1, &VBOVertex);
-    glGenBuffers(1, &EBO);
-    glGenBuffers(1, &VBOColor);
+    glGenVertexArrays(1, &VAOEdge);
+    glGenBuffers(1, &VBOEdge);
+    glGenVertexArrays(1, &VAOPath);
+    glGenBuffers(1, &VBOPath);
 }
 
 /* bind the right buffer and move data to GPU, unbind after
  * data transfer
 */
 void GridClass::moveDataToGPU(dataType dtType){
-    if(dtType == VERTEX){
-        /* Bind the Vertex Array Object first, then bind and 
-         * set vertex buffer(s)
-         * 
-         * Bind VAO-----|
-         *              |----Bind VBO
-         *                      |
-         *                      |-------- Transfer Vertex data
-         *                      |
-         *              |----Bind EBO
-         *                      |
-         *                      |-------- Transfer Index data
-         *                      |
-         * Unbind VAO-----------|
-        */
-        glBindVertexArray(VAO);
-        /* OpenGL has many types of buffer objects and the 
-         * buffer type of a vertex buffer object is 
-         * GL_ARRAY_BUFFER. OpenGL allows us to bind to several 
-         * buffers at once as long as they have a different 
-         * buffer type. We can bind the newly created buffer to 
-         * the GL_ARRAY_BUFFER target with the glBindBuffer 
-         * function
-         * 
-         * From that point on any buffer calls we make (on the 
-         * GL_ARRAY_BUFFER target) will be used to configure 
-         * the currently bound buffer, which is VBO.
+    STATS_PHASE(timer, PHASE_UPLOAD);
+    TRACE_SPAN(span, "moveDataToGPU");
+    if(dtType == COLOR){
+        /* the camera moved to a different part of the grid or level,
+         * upload all of the visible part
         */
-        glBindBuffer(GL_ARRAY_BUFFER, VBOVertex);
-        /* This fn copies the previously defined vertex data 
-         * into the buffer's memory.
-         * 
-         * glBufferData is a function specifically targeted 
-         * to copy user-defined data into the currently bound 
-         * buffer. Its first argument is the type of the buffer 
-         * we want to copy data into: the vertex buffer object 
-         * currently bound to the GL_ARRAY_BUFFER target. The 
-         * second argument specifies the size of the data (in 
-         * bytes) we want to pass to the buffer; a simple sizeof 
-         * of the vertex data suffices. The third parameter is 
-         * the actual data we want to send.
-         * 
-         * The fourth parameter specifies how we want the graphics 
-         * card to manage the given data. This can take 3 forms:
-         * 
-         * GL_STREAM_DRAW: the data is set only once and used 
-         * by the GPU at most a few times.
-         * GL_STATIC_DRAW: the data is set only once and used 
-         * many times.
-         * GL_DYNAMIC_DRAW: the data is changed a lot and used 
-         * many times.
-         * 
-         * NOTE: If, for instance, one would have a buffer with 
-         * data that is likely to change frequently, a usage type 
-         * of GL_DYNAMIC_DRAW ensures the graphics card will 
-         * place the data in memory that allows for faster writes.
-         * 
-         * As of now we stored the vertex data within memory on 
-         * the graphics card as managed by a vertex buffer object 
-         * named VBO. Next we want to create a vertex and fragment 
-         * shader that actually processes this data.
+        int level, x, y, width, height;
+        getViewRegion(level, x, y, width, height);
+        if(level != viewLevel || x != viewTexX || y != viewTexY || width != viewTexW || 
+        height != viewTexH){
+            viewLevel = level;
+            viewTexX = x;       viewTexY = y;
+            viewTexW = width;   viewTexH = height;
+            uploadCellStates(x, y, width, height);
+            clearDirtySpans();
+            return;
+        }
+        /* Walk the dirty rows in order and merge neighbouring row
+         * spans into one rectangle as long as the rectangle does not
+         * upload more than twice the bytes that actually changed.
+         * A path or a cluster of nodes becomes a few rectangles, while
+         * far apart cells don't drag the whole grid in between along
         */
-        glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), 
-                    static_cast<void*>(vertices.data()), GL_STATIC_DRAW);
-        /* Copy the index array into element buffer
+        int rectMinX = 0, rectMaxX = -1, rectMinY = 0, rectMaxY = -1;
+        long rectChanged = 0;
+        for(int y = dirtyRowMin; y <= dirtyRowMax; y++){
+            if(dirtySpanMax[y] < dirtySpanMin[y])
+                continue;
+            int spanMin = dirtySpanMin[y];
+            int spanMax = dirtySpanMax[y];
+            long spanBytes = spanMax - spanMin + 1;
+            if(rectMaxY >= 0){
+                int mergedMinX = std::min(rectMinX, spanMin);
+                int mergedMaxX = std::max(rectMaxX, spanMax);
+                long mergedBytes = (long)(mergedMaxX - mergedMinX + 1) * (y - rectMinY + 1);
+                if(y == rectMaxY + 1 && mergedBytes <= 2 * (rectChanged + spanBytes)){
+                    rectMinX = mergedMinX;
+                    rectMaxX = mergedMaxX;
+                    rectMaxY = y;
+                    rectChanged += spanBytes;
+                    continue;
+                }
+                uploadDirtyRect(rectMinX, rectMinY, rectMaxX - rectMinX + 1, 
+                                rectMaxY - rectMinY + 1);
+            }
+            rectMinX = spanMin;     rectMaxX = spanMax;
+            rectMinY = y;           rectMaxY = y;
+            rectChanged = spanBytes;
+        }
+        if(rectMaxY >= 0)
+            uploadDirtyRect(rectMinX, rectMinY, rectMaxX - rectMinX + 1, 
+                            rectMaxY - rectMinY + 1);
+        clearDirtySpans();
+    }
+
+    else if(dtType == EDGE){
+        if(edgeDirtyMax < edgeDirtyMin)
+            return;
+        glBindBuffer(GL_ARRAY_BUFFER, VBOEdge);
+        /* grow the buffer by doubling and upload everything, otherwise
+         * only the changed edge slots
         */
-        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
-        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(int), 
-                    static_cast<void*>(indices.data()), GL_STATIC_DRAW);
-        /* NOTE: do NOT unbind the BO while a VAO is active as the 
-         * bound element buffer object IS stored in the VAO
+        if(edgeVertices.size() > edgeBufferCapacity){
+            edgeBufferCapacity = std::max(edgeVertices.size(), 2 * edgeBufferCapacity);
+            glBufferData(GL_ARRAY_BUFFER, edgeBufferCapacity * sizeof(float), NULL, GL_DYNAMIC_DRAW);
+            edgeDirtyMin = 0;
+            edgeDirtyMax = edgeVertices.size()/4 - 1;
+        }
+        size_t offset = edgeDirtyMin * 4 * sizeof(float);
+        size_t size = (edgeDirtyMax - edgeDirtyMin + 1) * 4 * sizeof(float);
+        glBufferSubData(GL_ARRAY_BUFFER, offset, size, edgeVertices.data() + edgeDirtyMin * 4);
+        frameUploadBytes += size;
+        edgeDirtyMin = edgeVertices.size()/4;
+        edgeDirtyMax = -1;
+    }
+
+    else if(dtType == PATH){
+        if(!pathDirty)
+            return;
+        /* the path is short, upload all of it
         */
-        /* NOTE: You can unbind the VAO afterwards so other VAO 
-         * calls won't accidentally modify this VAO, but this 
-         * rarely happens. Modifying other VAOs requires a call 
-         * to glBindVertexArray anyways so we generally don't 
-         * unbind VAOs (nor VBOs) when it's not directly necessary.
-        */ 
-        glBindVertexArray(0);
+        glBindBuffer(GL_ARRAY_BUFFER, VBOPath);
+        glBufferData(GL_ARRAY_BUFFER, pathVertices.size() * sizeof(float), 
+                    pathVertices.data(), GL_DYNAMIC_DRAW);
+        frameUploadBytes += pathVertices.size() * sizeof(float);
+        pathDirty = false;
     }
+}
 
-    else if(dtType == COLOR){
-        /* Bind the Vertex Array Object first, then bind and 
-         * set vertex buffer(s)
-         * 
-         * Bind VAO-----|
-         *              |----Bind VBOColor
-         *                      |
-         *                      |-------- Transfer Color data
-         *                      |
-         * Unbind VAO-----------|
+/* upload a rectangle of the view level into the texture, (x,y) is
+ * in texels of that level. The rows are tightly packed bytes, so the 
+ * unpack alignment is 1, and the row length tells GL how far apart 
+ * the rows of the rectangle are in our array
+*/
+void GridClass::uploadCellStates(int x, int y, int width, int height){
+    int dim = levelDims[viewLevel];
+    glBindTexture(GL_TEXTURE_2D, textureCells);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, dim);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, x - viewTexX, y - viewTexY, width, height, 
+                    GL_RED_INTEGER, GL_UNSIGNED_BYTE, levels[viewLevel] + x + y * dim);
+    glPixelStorei(GL_UNPACK_ROW_LENGTH, 0);
+    frameUploadBytes += (long)width * height;
+}
+
+/* upload a rectangle of changed level 0 cells, only the part that
+ * is in view, at the view level
+*/
+void GridClass::uploadDirtyRect(int x, int y, int width, int height){
+    int x0 = std::max(x >> viewLevel, viewTexX);
+    int y0 = std::max(y >> viewLevel, viewTexY);
+    int x1 = std::min((x + width - 1) >> viewLevel, viewTexX + viewTexW - 1);
+    int y1 = std::min((y + height - 1) >> viewLevel, viewTexY + viewTexH - 1);
+    if(x1 < x0 || y1 < y0)
+        return;
+    uploadCellStates(x0, y0, x1 - x0 + 1, y1 - y0 + 1);
+}
+
+/* level and texel rectangle (in that level) of the part of the grid 
+ * under the camera. The level is the first one where the visible
+ * texels fit in the texture
+*/
+void GridClass::getViewRegion(int& level, int& x, int& y, int& width, int& height){
+    double size = viewSize.load();
+    double vx = viewX.load();
+    double vy = viewY.load();
+
+    level = 0;
+    while(level < levels.size() - 1 && ceil(size/(1 << level)) + 1 > textureDim)
+        level++;
+    /* visible cells, clipped to the grid
+    */
+    int cx0 = std::max((int)floor(vx), 0);
+    int cy0 = std::max((int)floor(vy), 0);
+    int cx1 = std::min((int)floor(vx + size), N - 1);
+    int cy1 = std::min((int)floor(vy + size), N - 1);
+
+    x = cx0 >> level;
+    y = cy0 >> level;
+    width = std::max((cx1 >> level) - x + 1, 0);
+    height = std::max((cy1 >> level) - y + 1, 0);
+}
+
+/* recompute the pyramid texels above level 0 cell (i,j), texel (x,y)
+ * of a level is column x and row y
+*/
+void GridClass::updateLevels(int i, int j){
+    int x = i, y = j;
+    for(int k = 1; k < levels.size(); k++){
+        x >>= 1;
+        y >>= 1;
+        int childDim = levelDims[k - 1];
+        unsigned char *child = levels[k - 1];
+        unsigned char value = 0;
+        for(int c = 0; c < 4 && value == 0; c++){
+            int cx = 2 * x + (c & 1);
+            int cy = 2 * y + (c >> 1);
+            if(cx < childDim && cy < childDim)
+                value = child[cx + cy * childDim];
+        }
+        unsigned char& texel = levels[k][x + y * levelDims[k]];
+        /* nothing changes further up
         */
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBOColor);
-        glBufferData(GL_ARRAY_BUFFER, colorArraySize * sizeof(float), color, GL_DYNAMIC_DRAW);
-        glBindVertexArray(0);
+        if(texel == value)
+            break;
+        texel = value;
+    }
+}
+
+/* zoom by factor keeping the grid position (pivotX, pivotY) at the 
+ * same place in the window
+*/
+void GridClass::zoomView(double factor, double pivotX, double pivotY){
+    double size = viewSize.load();
+    double newSize = std::min(std::max(size * factor, 8.0), 2.0 * N);
+    factor = newSize/size;
+    viewX = pivotX - (pivotX - viewX.load()) * factor;
+    viewY = pivotY - (pivotY - viewY.load()) * factor;
+    viewSize = newSize;
+    clampView();
+}
+
+/* pan by a fraction of the view
+*/
+void GridClass::panView(double dx, double dy){
+    double size = viewSize.load();
+    viewX = viewX.load() + dx * size;
+    viewY = viewY.load() + dy * size;
+    clampView();
+}
+
+/* keep the grid in view, a view larger than the grid is centered
+*/
+void GridClass::clampView(void){
+    double size = viewSize.load();
+    if(size >= N){
+        viewX = (N - size)/2;
+        viewY = (N - size)/2;
+    }
+    else{
+        viewX = std::min(std::max(viewX.load(), 0.0), N - size);
+        viewY = std::min(std::max(viewY.load(), 0.0), N - size);
     }
+    viewChanged = true;
+    frameDirty = true;
+}
+
+void GridClass::clearDirtySpans(void){
+    for(int y = dirtyRowMin; y <= dirtyRowMax; y++){
+        dirtySpanMin[y] = N;
+        dirtySpanMax[y] = -1;
+    }
+    dirtyRowMin = N;
+    dirtyRowMax = -1;
 }
 
 void GridClass::setVertexAttribute(dataType dtType){
-    if(dtType == VERTEX){
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBOVertex);
+    /* the grid quad has no vertex data, its corners are made up
+     * in the vertex shader, only the lines have vertex attributes
+    */
+    if(dtType == EDGE || dtType == PATH){
+        glBindVertexArray(dtType == EDGE ? VAOEdge : VAOPath);
+        glBindBuffer(GL_ARRAY_BUFFER, dtType == EDGE ? VBOEdge : VBOPath);
         /* The first parameter specifies which vertex attribute 
          * we want to configure. For example, if we specified the 
          * location of the position vertex attribute in the 
@@ -401,7 +648,7 @@ void GridClass::setVertexAttribute(dataType dtType){
          * currently bound to GL_ARRAY_BUFFER when calling 
          * glVertexAttribPointer
          */
-        glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 3 * (sizeof(float)), (void*)0);
+        glVertexAttribPointer(0, 2, GL_FLOAT, GL_FALSE, 2 * (sizeof(float)), (void*)0);
         /* Now that we specified how OpenGL should interpret the 
         * vertex data we should also enable the vertex attribute 
         * with glEnableVertexAttribArray giving the vertex 
@@ -411,13 +658,6 @@ void GridClass::setVertexAttribute(dataType dtType){
         glEnableVertexAttribArray(0);
         glBindVertexArray(0); 
     }
-    else if(dtType == COLOR){
-        glBindVertexArray(VAO);
-        glBindBuffer(GL_ARRAY_BUFFER, VBOColor);
-        glVertexAttribPointer(1, 4, GL_FLOAT, GL_FALSE, 4 * (sizeof(float)), (void*)0);
-        glEnableVertexAttribArray(1);                  
-        glBindVertexArray(0); 
-    }
 }
 
 /* query GLFW whether relevant keys are pressed/released 
@@ -433,10 +673,29 @@ void GridClass::processInput(GLFWwindow* window){
     if(glfwGetKey(window, GLFW_KEY_ESCAPE) == GLFW_PRESS)
         glfwSetWindowShouldClose(window, true);
 
-    /* step mode
+    /* step mode, one step per key press
     */
-    if(glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS)
+    bool stepKeyPressed = glfwGetKey(window, GLFW_KEY_Z) == GLFW_PRESS;
+    if(stepKeyPressed && !stepKeyDown)
         stepMode = true;
+    stepKeyDown = stepKeyPressed;
+    /* C - start/stop recording the window
+    */
+    bool captureKeyPressed = glfwGetKey(window, GLFW_KEY_C) == GLFW_PRESS;
+    if(captureKeyPressed && !captureKeyDown)
+        captureRequested = !captureRequested;
+    captureKeyDown = captureKeyPressed;
+    /* T - start/stop recording the trace
+    */
+    bool traceKeyPressed = glfwGetKey(window, GLFW_KEY_T) == GLFW_PRESS;
+    if(traceKeyPressed && !traceKeyDown){
+        if(traceEnabled())
+            traceStop();
+        else
+            traceStart();
+        LOG_INFO(LOG_GRID, "Trace "<<(traceEnabled() ? "started" : "stopped"));
+    }
+    traceKeyDown = traceKeyPressed;
 
     /* Added input controls here
      * S - confirm start cell position (only once)
@@ -451,6 +710,26 @@ void GridClass::processInput(GLFWwindow* window){
         startCellSet = true;
     if(glfwGetKey(window, GLFW_KEY_E) == GLFW_PRESS)
         endCellSet = true;
+
+    /* camera controls, mouse wheel zooms about the cursor and the 
+     * arrow keys pan
+    */
+    double scroll = scrollOffset.exchange(0);
+    if(scroll != 0){
+        double x, y;
+        glfwGetCursorPos(window, &x, &y);
+        double size = viewSize.load();
+        zoomView(pow(0.9, scroll), viewX.load() + (x/windowDim) * size, 
+                 viewY.load() + ((windowDim - y)/windowDim) * size);
+    }
+    if(glfwGetKey(window, GLFW_KEY_LEFT) == GLFW_PRESS)
+        panView(-0.02, 0);
+    if(glfwGetKey(window, GLFW_KEY_RIGHT) == GLFW_PRESS)
+        panView(0.02, 0);
+    if(glfwGetKey(window, GLFW_KEY_DOWN) == GLFW_PRESS)
+        panView(0, -0.02);
+    if(glfwGetKey(window, GLFW_KEY_UP) == GLFW_PRESS)
+        panView(0, 0.02);
 }
 
 void GridClass::openGLClose(void){
@@ -458,9 +737,11 @@ void GridClass::openGLClose(void){
      * their purpose
     */
     glDeleteVertexArrays(1, &VAO);
-    glDeleteBuffers(1, &VBOVertex);
-    glDeleteBuffers(1, &EBO);
-    glDeleteBuffers(1, &VBOColor);
+    glDeleteTextures(1, &textureCells);
+    glDeleteVertexArrays(1, &VAOEdge);
+    glDeleteBuffers(1, &VBOEdge);
+    glDeleteVertexArrays(1, &VAOPath);
+    glDeleteBuffers(1, &VBOPath);
     /* As soon as we exit the render loop we would like 
      * to properly clean/delete all of GLFW's resources 
      * that were allocated. We can do this via the glfwTerminate 
@@ -469,149 +750,326 @@ void GridClass::openGLClose(void){
     glfwTerminate();
 }
 
-/* (i,j) will be the top left coordinates of a grid cell
- * pass in (i,j) to get vertices based on all variable 
- * parameters of the render screen. 
- * 
- * we need our grid cells to align as below
- * ----------------(+1)--------------
- * |        |       |       |       |
- * ----------------------------------
- * |        |       |       |       |
- * (-1)-------------0--------------(1)
- * |        |       |       |       |
- * ----------------------------------
- * |        |       |       |       |
- * ----------------(-1)--------------      
- * The function generates the 4 vertices required to draw
- * 2 triangles forming a quad. This also generates the 
- * indices vector that specifies the order in which these
- * vertices are to be drawn.
+/* palette index of a color, the color is added to the palette
+ * if it is new. Consecutive calls mostly use the same color, so
+ * the last match is checked first
 */
-void GridClass::genCellVertices(float i, float j){
-    /* set top left first
-    */
-    vertices.push_back(i);
-    vertices.push_back(j);
-    vertices.push_back(0.0);
-    /* bottom left
-    */
-    vertices.push_back(i);
-    vertices.push_back(j - cellDim);
-    vertices.push_back(0.0);
-    /* bottom right
+int GridClass::getPaletteIdx(colorVal cVal, float alpha){
+    for(int k = -1; k < paletteSize; k++){
+        int idx = k < 0 ? lastPaletteIdx : k;
+        float *entry = &palette[4 * idx];
+        if(idx < paletteSize && entry[0] == cVal.R && entry[1] == cVal.G && 
+        entry[2] == cVal.B && entry[3] == alpha){
+            lastPaletteIdx = idx;
+            return idx;
+        }
+    }
+    if(paletteSize == maxPaletteSize){
+        LOG_WARN(LOG_GRID, "Cell color palette is full");
+        logFlush();
+        assert(false);
+        return 0;
+    }
+    float *entry = &palette[4 * paletteSize];
+    entry[0] = cVal.R;
+    entry[1] = cVal.G;
+    entry[2] = cVal.B;
+    entry[3] = alpha;
+    paletteDirty = true;
+    lastPaletteIdx = paletteSize;
+    return paletteSize++;
+}
+
+/* set the color of a cell
+*/
+void GridClass::genCellColor(int i, int j, colorVal cVal, float alpha){
+    /* nothing to color in a headless grid
     */
-    vertices.push_back(i + cellDim);
-    vertices.push_back(j - cellDim);
-    vertices.push_back(0.0);
-    /* top right
+    if(cellStates == NULL)
+        return;
+    /* called from the simulation thread, hand the change over to the 
+     * render thread. If the ring is full, wait for the render thread to
+     * drain it, unless the render loop has already exited
     */
-    vertices.push_back(i + cellDim);
-    vertices.push_back(j);
-    vertices.push_back(0.0);
+    if(simulationThreaded){
+        cellUpdate_t update = {i, j, cVal, alpha};
+        while(!cellUpdates->push(update)){
+            if(stopSimulation.load(std::memory_order_relaxed))
+                return;
+            std::this_thread::yield();
+        }
+        return;
+    }
+    applyCellColor(i, j, cVal, alpha);
+}
 
-    /* create indices to specify the order in which the above 
-     * vertives are plotted
-    */
-    static int eboIdx = 0;
-    indices.push_back(eboIdx);
-    indices.push_back(eboIdx + 1);
-    indices.push_back(eboIdx + 3);
+/* cell (i,j) is drawn at column i and row j counted from the bottom,
+ * so it is texel (i,j) of the cell states texture and dirties row j
+*/
+void GridClass::applyCellColor(int i, int j, colorVal cVal, float alpha){
+    cellStates[i + j * N] = (unsigned char)getPaletteIdx(cVal, alpha);
+    updateLevels(i, j);
+    frameDirty = true;
+    dirtySpanMin[j] = std::min(dirtySpanMin[j], i);
+    dirtySpanMax[j] = std::max(dirtySpanMax[j], i);
+    dirtyRowMin = std::min(dirtyRowMin, j);
+    dirtyRowMax = std::max(dirtyRowMax, j);
+}
 
-    indices.push_back(eboIdx + 1);
-    indices.push_back(eboIdx + 2);
-    indices.push_back(eboIdx + 3);
-    eboIdx += 4;
+/* center of cell (i,j) in grid coordinates, i is along the x axis
+ * like in the cell states texture. The line shader applies the camera
+*/
+void GridClass::getCellCenter(int i, int j, float& x, float& y){
+    x = i + 0.5;
+    y = j + 0.5;
 }
 
-/* This function accepts (i,j) in grid cell coordinate format
- * We need to transform to screen space before invoking the 
- * sub function
+void GridClass::setLineStyle(colorVal _edgeColor, float _edgeAlpha, colorVal _pathColor, 
+float _pathAlpha, int _pathWidth){
+    edgeColor = _edgeColor;
+    edgeAlpha = _edgeAlpha;
+    pathColor = _pathColor;
+    pathAlpha = _pathAlpha;
+    pathWidth = _pathWidth;
+}
+
+/* same as genCellColor, a line update made on the simulation thread
+ * is handed over to the render thread
 */
-void GridClass::genCellVerticesWrapper(int i, int j){
-    /* convert 2d coordinates to 1D, this will range from 
-     * 0 to N*N-1
-     * For example: let N = 4, cellDim = 0.5
-     * So idx ranges from 0 to 15
-    */
-    int idx = i + N * j;
-    /* first lets place idx 0 to N-1 cellDim apart
-     * then (N) to 2(N)-1 cellsize apart, repeat this
-     * till (N-1)N to ((N)(N))-1. Lets call
-     * this row based placement
-     *                          -1
-     *                          |----------------------------------------
-     *                          | 1.5,0   | 1.5,0.5 | 1.5,1.0 | 1.5,1.5 |
-     *                          |----------------------------------------
-     *                          | 1.0,0   | 1.0,0.5 | 1.0,1.0 | 1.0,1.5 |
-     *                          |----------------------------------------
-     *                          | 0.5,0   | 0.5,0.5 | 0.5,1.0 | 0.5,1.5 |
-     *                          |----------------------------------------
-     *                          | 0,0     | 0,0.5   | 0,1.0   | 0,1.5   | 
-     * -1 ----------------------0---------------------------------------- +1
-     *                          |
-     *                          |
-     *                          -1
-     * Now that all points are in the screen space, they
-     * are still in the first quadrant, we need to translate
-     * them to lower left so that (0,0) is at the lower left
-     * 
-     * Finally, we need to shift by cellSize upwards to get
-     * the top left vertex
+void GridClass::pushLineUpdate(lineUpdate_t update){
+    if(cellStates == NULL)
+        return;
+    if(simulationThreaded){
+        while(!lineUpdates->push(update)){
+            if(stopSimulation.load(std::memory_order_relaxed))
+                return;
+            std::this_thread::yield();
+        }
+        return;
+    }
+    applyLineUpdate(update);
+}
+
+/* draw the tree edge from parent to child, a node has only one
+ * parent, so if the child already has an edge it is moved
+*/
+void GridClass::genEdgeLine(std::pair<int, int> parent, std::pair<int, int> child){
+    lineUpdate_t update = {EDGE_LINE, parent.first, parent.second, child.first, child.second};
+    pushLineUpdate(update);
+}
+
+/* replace the drawn path, path holds the node coords from one end to
+ * the other. An empty path removes it
+*/
+void GridClass::genPathLines(const std::vector<std::pair<int, int>>& path){
+    lineUpdate_t clear = {PATH_CLEAR, 0, 0, 0, 0};
+    pushLineUpdate(clear);
+    for(int k = 1; k < path.size(); k++){
+        lineUpdate_t update = {PATH_LINE, path[k - 1].first, path[k - 1].second, 
+                               path[k].first, path[k].second};
+        pushLineUpdate(update);
+    }
+}
+
+void GridClass::applyLineUpdate(lineUpdate_t update){
+    frameDirty = true;
+    if(update.layer == PATH_CLEAR){
+        pathVertices.clear();
+        pathDirty = true;
+        return;
+    }
+
+    float x1, y1, x2, y2;
+    getCellCenter(update.i1, update.j1, x1, y1);
+    getCellCenter(update.i2, update.j2, x2, y2);
+
+    if(update.layer == EDGE_LINE){
+        int childIdx = update.i2 + update.j2 * N;
+        std::unordered_map<int, int>::iterator it = edgeSlots.find(childIdx);
+        int slot;
+        if(it == edgeSlots.end()){
+            slot = edgeVertices.size()/4;
+            edgeSlots[childIdx] = slot;
+            edgeVertices.resize(edgeVertices.size() + 4);
+        }
+        else
+            slot = it->second;
+
+        float *v = &edgeVertices[slot * 4];
+        v[0] = x1;  v[1] = y1;
+        v[2] = x2;  v[3] = y2;
+        edgeDirtyMin = std::min(edgeDirtyMin, slot);
+        edgeDirtyMax = std::max(edgeDirtyMax, slot);
+        return;
+    }
+
+    /* path segment, a quad around the segment that is pathWidth cells
+     * wide on either side
+    */
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float len = sqrt(dx * dx + dy * dy);
+    if(len == 0)
+        return;
+    float halfWidth = pathWidth + 0.5;
+    float nx = -dy/len * halfWidth;
+    float ny = dx/len * halfWidth;
+    float quad[] = {
+        x1 + nx, y1 + ny,   x1 - nx, y1 - ny,   x2 - nx, y2 - ny,
+        x1 + nx, y1 + ny,   x2 - nx, y2 - ny,   x2 + nx, y2 + ny
+    };
+    pathVertices.insert(pathVertices.end(), quad, quad + 12);
+    pathDirty = true;
+}
+
+/* apply all color and line changes pushed by the simulation thread 
+ * so far, this is called by the render thread once per frame. Returns
+ * false if there was nothing to apply
+*/
+bool GridClass::drainCellUpdates(void){
+    /* color updates of the threaded simulation are applied here, when
+     * the simulation runs on the render thread they are part of the
+     * phase that made them
     */
-    float rowIdx = (idx / N) * cellDim;
-    float colIdx = (idx % N) * cellDim;
+    STATS_PHASE(timer, PHASE_COLOR);
+    bool drained = false;
+    cellUpdate_t update;
+    while(cellUpdates->pop(update)){
+        applyCellColor(update.i, update.j, update.cVal, update.alpha);
+        drained = true;
+    }
+    lineUpdate_t lineUpdate;
+    while(lineUpdates->pop(lineUpdate)){
+        applyLineUpdate(lineUpdate);
+        drained = true;
+    }
+    return drained;
+}
 
-    float x = rowIdx - (N/2) * cellDim;
-    float y = colIdx - (N/2) * cellDim;
-    
-    y = y + cellDim;
-    genCellVertices(x, y);
+/* block the render thread until an event arrives or the timeout runs
+ * out. The simulation thread posts an empty event when it pushed 
+ * updates while the render thread is waiting. The fences make sure 
+ * that either the render thread sees the updates before waiting, or 
+ * the simulation thread sees renderWaiting after pushing
+*/
+void GridClass::waitForEvents(void){
+    if(simulationThreaded){
+        renderWaiting = true;
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if(cellUpdates->size() != 0 || lineUpdates->size() != 0){
+            renderWaiting = false;
+            glfwPollEvents();
+            return;
+        }
+    }
+    glfwWaitEventsTimeout(idleWaitTime);
+    renderWaiting = false;
 }
 
-/* get ending eboIdx from cell location, makes it easier 
- * to set color of a cell based on its location
- * ---------------- .....
- * | 0,0  | 1,0   | .....
- * ---------------- .....
- *        ^       ^
- * eboIdx = 4     eboIdx = 8
+/* the simulation thread, runs the simulation steps back to back
+ * until the render loop exits
 */
-int GridClass::getEboIdx(int i, int j){
-    return 4 + ((i + N * j) * 4);
-}
-
-/* generate color value for a cell by adding color to all 4
- * vertices. This fn will be called after generating all 4 
- * vertices of a cell
- *
- *         v0       v1       v2       v3
- *         x,y,z    x,y,z    x,y,z    x,y,z
- *         r,g,b,a  r,g,b,a  r,g,b,a  r,g,b,a
- *                                           ^
- *                                           |
- *                                           eboIdx = 4
+void GridClass::simulationLoop(void){
+    traceSetThreadName("simulation");
+    while(!stopSimulation.load(std::memory_order_acquire)){
+        /* |-----------------------------------------------------|
+         * |                OVERRIDE IN CHILD CLASS              |
+         * |-----------------------------------------------------|
+        */
+        setStartAndEndCells();
+        bool stepped = simulationStep();
+        /* |-----------------------------------------------------|
+         * |                        END                          |
+         * |-----------------------------------------------------|
+        */
+        /* wake up an idle render thread to draw what we pushed, the
+         * start and end cell highlights are pushed even when no step
+         * was taken. If the queues are already drained there is
+         * nothing left to draw
+        */
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if((cellUpdates->size() != 0 || lineUpdates->size() != 0) && renderWaiting.exchange(false))
+            glfwPostEmptyEvent();
+        /* nothing to simulate until the start and end cells are
+         * set or the next step is requested, sleep until the render
+         * thread has seen new input
+        */
+        if(!stepped){
+            std::unique_lock<std::mutex> lock(inputMtx);
+            inputChanged.wait_for(lock, std::chrono::milliseconds(100));
+        }
+    }
+}
+
+/* simulation on the render thread, runs as many steps as fit in the
+ * frame budget. The steps are run in batches sized from the measured
+ * step cost, so the clock is read only a few times per frame. Returns
+ * false if there was nothing to simulate
 */
-void GridClass::genCellColor(int i, int j, colorVal cVal, float alpha){
-    int n = getEboIdx(i, j) * 4;
-    int cellColorBatchSize = 16; /* 4 vertices, 4 color values
-    */
-    int k = n - cellColorBatchSize;
-    /* set color for all 4 vertices  from top left,
-     * bottom left, bottom right and top right
-    */
-    for(int i = 0; i < 4; i++){
-        color[k++] = cVal.R;
-        color[k++] = cVal.G;
-        color[k++] = cVal.B;
-        color[k++] = alpha;       
+bool GridClass::simulationFrame(void){
+    /* |-----------------------------------------------------|
+     * |                OVERRIDE IN CHILD CLASS              |
+     * |-----------------------------------------------------|
+    */
+    /* set start and end goal cells
+    */
+    setStartAndEndCells();
+    /* read cell states and set the cell colors
+    */
+    if(frameBudget <= 0)
+        return simulationStep();
+
+    std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+    double elapsed = 0;
+    bool stepped = false;
+    while(elapsed < frameBudget){
+        /* steps that fit in what is left of the budget, a single step
+         * until the cost has been measured
+        */
+        int batch = 1;
+        if(iterationCost > 0)
+            batch = std::max(1.0, std::min((frameBudget - elapsed)/iterationCost, 1e6));
+
+        int k;
+        for(k = 0; k < batch; k++){
+            if(!simulationStep())
+                break;
+        }
+        double now = std::chrono::duration<double>(std::chrono::steady_clock::now() - 
+        frameStart).count();
+        /* running average of the step cost
+        */
+        if(k > 0){
+            stepped = true;
+            double cost = (now - elapsed)/k;
+            iterationCost = iterationCost == 0 ? cost : 0.8 * iterationCost + 0.2 * cost;
+        }
+        elapsed = now;
+        /* idle, wait for input
+        */
+        if(k < batch)
+            break;
     }
+    /* |-----------------------------------------------------|
+     * |                        END                          |
+     * |-----------------------------------------------------|
+    */
+    return stepped;
+}
+
+double GridClass::getAverageFrameTime(void){
+    return avgFrameTime;
+}
+
+long GridClass::getFrameUploadBytes(void){
+    return frameUploadBytes;
 }
 
 /* this is the main render loop that runs the simulation at 
  * every time step
 */
-void GridClass::runRender(void){
+void GridClass::runRender(bool _simulationThreaded, double _frameBudget){
+    frameBudget = _frameBudget/1000.0;
     /* |-----------------------------------------------------|
      * |                OVERRIDE IN CHILD CLASS              |
      * |-----------------------------------------------------|
@@ -627,6 +1085,25 @@ void GridClass::runRender(void){
     /* the shader class we will be using here
     */
     ShaderClass Shader;
+    /* the cell states texture is bound to texture unit 0
+    */
+    Shader.use();
+    Shader.setInt(UNIFORM_CELL_STATES, 0);
+    Shader.setBool(UNIFORM_STROKE, stroke);
+    Shader.setInt(UNIFORM_GRID_SIZE, N);
+    /* and the one for the line overlay
+    */
+    ShaderClass LineShader(LINE_SHADER);
+    /* from here on the simulation thread owns the cell states, the
+     * render thread only handles input and draws
+    */
+    if(_simulationThreaded){
+        cellUpdates = new RingBufferClass<cellUpdate_t>(1 << 18);
+        lineUpdates = new RingBufferClass<lineUpdate_t>(1 << 16);
+        stopSimulation = false;
+        simulationThreaded = true;
+        simulationThread = std::thread(&GridClass::simulationLoop, this);
+    }
     /* We don't want the application to draw a single image 
      * and then immediately quit and close the window. We 
      * want the application to keep drawing images and handling 
@@ -643,7 +1120,13 @@ void GridClass::runRender(void){
      * loop stops running, after which we can close the 
      * application.
     */
+    traceSetThreadName("render");
     while (!glfwWindowShouldClose(window)){
+        std::chrono::steady_clock::time_point frameStart = std::chrono::steady_clock::now();
+        /* one span per pass of the render loop, idle waits included
+        */
+        TRACE_SPAN(span, "runRender");
+        frameUploadBytes = 0;
         /* We want to have some form of input control in GLFW 
          * and we can achieve this with several of GLFW's
          * input functions. We'll be using GLFW's glfwGetKey 
@@ -654,6 +1137,38 @@ void GridClass::runRender(void){
          * organized:
         */
         processInput(window);
+        if(captureRequested != capturing){
+            if(captureRequested)
+                beginCapture();
+            else
+                endCapture();
+        }
+        /* Use the shader object that we linked using our shader 
+         * files
+        */
+        Shader.use();
+        bool stepped;
+        if(simulationThreaded)
+            stepped = drainCellUpdates();
+        else
+            stepped = simulationFrame();
+        /* let the simulation thread look at the input
+        */
+        if(simulationThreaded)
+            inputChanged.notify_one();
+        /* Render on demand, nothing is drawn if the grid, the lines
+         * and the camera did not change. If the simulation did not 
+         * step either we are idle and block until an event arrives
+         * (or the simulation thread wakes us up) instead of spinning
+        */
+        if(!frameDirty){
+            if(!stepped)
+                waitForEvents();
+            else
+                glfwPollEvents();
+            continue;
+        }
+        frameDirty = false;
         /* We want to clear the screen with a color of our 
          * choice. At the start of frame we want to clear the 
          * screen. Otherwise we would still see the results 
@@ -678,27 +1193,22 @@ void GridClass::runRender(void){
         glClearColor(whiteVal.R, whiteVal.G, whiteVal.B, 1.0f);
         glClear(GL_COLOR_BUFFER_BIT);
 
-        /* Use the shader object that we linked using our shader 
-         * files
-        */
-        Shader.use();
-        /* |-----------------------------------------------------|
-         * |                OVERRIDE IN CHILD CLASS              |
-         * |-----------------------------------------------------|
-        */
-        /* set start and end goal cells
-        */
-        setStartAndEndCells();
-        /* read cell states and set color array
-        */
-        simulationStep();
-        /* |-----------------------------------------------------|
-         * |                        END                          |
-         * |-----------------------------------------------------|
-        */        
-        /* move color array to GPU
+        /* move the changed cell states to GPU, and the palette if
+         * a new color showed up
         */
         moveDataToGPU(COLOR);
+        if(paletteDirty){
+            Shader.setVec4Array(UNIFORM_PALETTE, paletteSize, palette);
+            paletteDirty = false;
+        }
+        /* the camera and the part of the grid in the texture
+        */
+        if(viewChanged){
+            Shader.setVec2(UNIFORM_VIEW_ORIGIN, viewX.load(), viewY.load());
+            Shader.setFloat(UNIFORM_VIEW_SIZE, viewSize.load());
+        }
+        Shader.setInt(UNIFORM_LOD_LEVEL, viewLevel);
+        Shader.setIVec2(UNIFORM_TEX_ORIGIN, viewTexX, viewTexY);
         /* Do we want the data rendered as a collection of points, 
          * a collection of triangles or perhaps just one long line? 
          * Those hints are called primitives and are given to OpenGL 
@@ -712,18 +1222,39 @@ void GridClass::runRender(void){
          * The last argument specifies how many vertices we want to 
          * draw
          * 
-         * Instead of glDrawArrays, we use glDrawElement because of
-         * EBO. The first argument specifies the mode we want to draw 
-         * in, similar to glDrawArrays. The second argument is the 
-         * count or number of elements we'd like to draw. The third 
-         * argument is the type of the indices which is of type 
-         * GL_UNSIGNED_INT. The last argument allows us to specify 
-         * an offset in the EBO (or pass in an index array, but 
-         * that is when you're not using element buffer objects), 
-         * but we're just going to leave this at 0.
+         * The grid is 4 vertices drawn as a triangle strip, the 
+         * vertex shader places them from gl_VertexID. The VAO has 
+         * no attributes but core OpenGL still needs one bound
         */
+        glActiveTexture(GL_TEXTURE0);
+        glBindTexture(GL_TEXTURE_2D, textureCells);
         glBindVertexArray(VAO);
-        glDrawElements(GL_TRIANGLES, indices.size(), GL_UNSIGNED_INT, 0);
+        glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+        /* tree edges and the path over the grid, the cost of this
+         * depends on the number of edges and not on the grid size
+        */
+        moveDataToGPU(EDGE);
+        moveDataToGPU(PATH);
+        LineShader.use();
+        if(viewChanged){
+            LineShader.setVec2(UNIFORM_VIEW_ORIGIN, viewX.load(), viewY.load());
+            LineShader.setFloat(UNIFORM_VIEW_SIZE, viewSize.load());
+            viewChanged = false;
+        }
+        if(edgeVertices.size() != 0){
+            LineShader.setVec4(UNIFORM_LINE_COLOR, edgeColor.R, edgeColor.G, edgeColor.B, edgeAlpha);
+            glBindVertexArray(VAOEdge);
+            glDrawArrays(GL_LINES, 0, edgeVertices.size()/2);
+        }
+        if(pathVertices.size() != 0){
+            LineShader.setVec4(UNIFORM_LINE_COLOR, pathColor.R, pathColor.G, pathColor.B, pathAlpha);
+            glBindVertexArray(VAOPath);
+            glDrawArrays(GL_TRIANGLES, 0, pathVertices.size()/2);
+        }
+        /* the back buffer is read before it is swapped
+        */
+        if(capturing)
+            captureFrame();
         /* The glfwSwapBuffers will swap the color buffer (a large 
          * 2D buffer that contains color values for each pixel in 
          * GLFW's window) that is used to render to during this render 
@@ -751,5 +1282,34 @@ void GridClass::runRender(void){
          * functions (which we can register via callback methods). 
         */
         glfwPollEvents();
+        /* frame timer
+        */
+        lastFrameTime = std::chrono::duration<double>(std::chrono::steady_clock::now() - 
+        frameStart).count();
+        numFrames++;
+        if(numFrames == 1){
+            double firstFrameTime = std::chrono::duration<double>(std::chrono::steady_clock::now() -
+            startTime).count();
+            LOG_INFO(LOG_GRID, "First frame after "<<firstFrameTime * 1000.0<<" ms, shaders "
+                     <<(Shader.fromCache && LineShader.fromCache ? "cached" : "compiled"));
+        }
+        avgFrameTime += (lastFrameTime - avgFrameTime)/numFrames;
+        totalUploadBytes += frameUploadBytes;
+        if(capturing){
+            numCaptureFrames++;
+            captureFrameTime += (lastFrameTime - captureFrameTime)/numCaptureFrames;
+        }
+    }
+    if(capturing)
+        endCapture();
+    LOG_INFO(LOG_GRID, "Average frame time: "<<avgFrameTime * 1000.0<<" ms over "
+             <<numFrames<<" frames");
+    LOG_INFO(LOG_GRID, "Average upload: "<<(numFrames == 0 ? 0 : totalUploadBytes/numFrames)
+             <<" bytes per frame (full grid "<<(long)N * N<<" bytes)");
+
+    if(simulationThreaded){
+        stopSimulation = true;
+        simulationThread.join();
+        simulationThreaded = false;
     }
 }
@@ -0,0 +1,196 @@
+#include "../../../Include/Visualization/Grid/Grid.h"
+#include "../../../Include/Utils/Log.h"
+#include <stdio.h>
+#include <chrono>
+
+void GridClass::startCapture(const std::string& prefix, captureFormat format){
+    capturePrefix = prefix;
+    captureFmt = format;
+    captureRequested = true;
+}
+
+/* create the PBOs and the writer thread. Runs on the render thread
+*/
+void GridClass::beginCapture(void){
+    /* the framebuffer can be larger than the window on high DPI
+     * displays
+    */
+    glfwGetFramebufferSize(window, &captureWidth, &captureHeight);
+    size_t frameBytes = (size_t)captureWidth * captureHeight * 3;
+    /* rows are tightly packed, 3 bytes per pixel
+    */
+    glPixelStorei(GL_PACK_ALIGNMENT, 1);
+    glGenBuffers(captureRingSize, capturePBOs);
+    for(int k = 0; k < captureRingSize; k++){
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, capturePBOs[k]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, NULL, GL_STREAM_READ);
+        captureFences[k] = 0;
+        captureMaps[k] = NULL;
+        captureSlotBusy[k] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    captureIssued = 0;
+    captureMapped = 0;
+
+    captureQueue = new RingBufferClass<int>(captureRingSize);
+    captureDone = new RingBufferClass<int>(captureRingSize);
+    stopCaptureWriter = false;
+    captureThread = std::thread(&GridClass::captureWriterLoop, this);
+    capturing = true;
+    /* make sure the current view is in the recording
+    */
+    frameDirty = true;
+    LOG_INFO(LOG_GRID, "Capture started, "<<captureWidth<<"x"<<captureHeight);
+}
+
+/* map the PBOs still in flight, then let the writer finish the queue
+ * and free everything
+*/
+void GridClass::endCapture(void){
+    while(captureMapped < captureIssued)
+        mapCaptureSlot(captureMapped % captureRingSize);
+
+    stopCaptureWriter = true;
+    captureReady.notify_one();
+    captureThread.join();
+    releaseCaptureSlots();
+    glDeleteBuffers(captureRingSize, capturePBOs);
+    delete captureQueue;
+    delete captureDone;
+    captureQueue = NULL;
+    captureDone = NULL;
+    capturing = false;
+    captureRequested = false;
+
+    LOG_INFO(LOG_GRID, "Capture stopped, "<<captureFrameId<<" frames written, "<<captureDropped
+             <<" dropped, "<<captureStalls<<" stalls. Average frame time while capturing: "
+             <<captureFrameTime * 1000.0<<" ms");
+}
+
+/* start the read back of the frame just drawn into the next PBO. The
+ * PBOs the writer is done with are unmapped first, and the one read
+ * captureMapDelay frames ago is handed to the writer
+*/
+void GridClass::captureFrame(void){
+    releaseCaptureSlots();
+    if(captureIssued - captureMapped == captureMapDelay)
+        mapCaptureSlot(captureMapped % captureRingSize);
+
+    /* the writer is behind and still has the next PBO, drop the frame
+     * rather than wait
+    */
+    int slot = captureIssued % captureRingSize;
+    if(captureSlotBusy[slot]){
+        captureDropped++;
+        return;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capturePBOs[slot]);
+    /* with a PBO bound the last argument is an offset into the
+     * buffer, the copy happens on the GPU
+    */
+    glReadPixels(0, 0, captureWidth, captureHeight, GL_RGB, GL_UNSIGNED_BYTE, 0);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    captureFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    captureIssued++;
+}
+
+/* map a PBO and queue it for the writer, it stays mapped until the
+ * writer gives it back
+*/
+void GridClass::mapCaptureSlot(int slot){
+    captureMapped++;
+    /* the copy should be done by now, a wait here is counted as a
+     * stall
+    */
+    if(glClientWaitSync(captureFences[slot], 0, 0) == GL_TIMEOUT_EXPIRED){
+        captureStalls++;
+        glClientWaitSync(captureFences[slot], GL_SYNC_FLUSH_COMMANDS_BIT, 1000000000);
+    }
+    glDeleteSync(captureFences[slot]);
+    captureFences[slot] = 0;
+
+    size_t frameBytes = (size_t)captureWidth * captureHeight * 3;
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, capturePBOs[slot]);
+    void *pixels = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+    if(pixels == NULL){
+        LOG_WARN(LOG_GRID, "glMapBufferRange() failed, frame dropped");
+        captureDropped++;
+        return;
+    }
+    captureMaps[slot] = (unsigned char*)pixels;
+    captureSlotBusy[slot] = true;
+    captureQueue->push(slot);
+    captureReady.notify_one();
+}
+
+/* unmap the PBOs the writer has written, they can be read into again
+*/
+void GridClass::releaseCaptureSlots(void){
+    int slot;
+    while(captureDone->pop(slot)){
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, capturePBOs[slot]);
+        glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        captureMaps[slot] = NULL;
+        captureSlotBusy[slot] = false;
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+/* writer thread, writes the queued frames in order from the mapped
+ * PBOs and gives the slots back
+*/
+void GridClass::captureWriterLoop(void){
+    std::ofstream rawFile;
+    if(captureFmt == CAPTURE_RAW){
+        /* a second recording in the same run is appended
+        */
+        rawFile.open(capturePrefix + ".raw", std::ios::binary |
+                     (captureFrameId == 0 ? std::ios::trunc : std::ios::app));
+        if(!rawFile)
+            LOG_WARN(LOG_GRID, "Could not open "<<capturePrefix<<".raw");
+    }
+
+    int slot;
+    while(true){
+        if(captureQueue->pop(slot)){
+            writeCaptureFrame(captureMaps[slot], rawFile);
+            captureDone->push(slot);
+            continue;
+        }
+        /* all frames are queued before the stop flag is set, so the
+         * queue is drained once more after seeing it
+        */
+        if(stopCaptureWriter){
+            while(captureQueue->pop(slot)){
+                writeCaptureFrame(captureMaps[slot], rawFile);
+                captureDone->push(slot);
+            }
+            break;
+        }
+        std::unique_lock<std::mutex> lock(captureMtx);
+        captureReady.wait_for(lock, std::chrono::milliseconds(10));
+    }
+}
+
+/* GL rows start at the bottom, they are written top row first
+*/
+void GridClass::writeCaptureFrame(const unsigned char *pixels, std::ofstream& rawFile){
+    size_t rowBytes = (size_t)captureWidth * 3;
+    std::ofstream ppmFile;
+    std::ofstream *file = &rawFile;
+    if(captureFmt == CAPTURE_PPM){
+        char fileName[16];
+        snprintf(fileName, sizeof(fileName), "_%06ld.ppm", captureFrameId);
+        ppmFile.open(capturePrefix + fileName, std::ios::binary);
+        if(!ppmFile){
+            LOG_WARN(LOG_GRID, "Could not open "<<capturePrefix + fileName);
+            return;
+        }
+        ppmFile<<"P6\n"<<captureWidth<<" "<<captureHeight<<"\n255\n";
+        file = &ppmFile;
+    }
+    for(int y = captureHeight - 1; y >= 0; y--)
+        file->write((const char*)pixels + y * rowBytes, rowBytes);
+    captureFrameId++;
+}
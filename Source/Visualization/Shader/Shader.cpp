@@ -1,54 +1,198 @@
 #include "../../../Include/Visualization/Shader/Shader.h"
+#include "../../../Include/Visualization/Shader/ShaderSources.h"
+#include <GLFW/glfw3.h>
 #include <iostream>
 #include <fstream>
 #include <sstream>
+#include <filesystem>
+#include <vector>
+#include <random>
+#include <cstdint>
+#include <cstdlib>
 
-ShaderClass::ShaderClass(void){
-    /* retrieve the vertex/fragment source code from 
-     * filePath
+/* program binaries are core in OpenGL 4.1, the loader only goes up to
+ * 4.0 so the entry points are looked up at run time
+*/
+#ifndef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT 0x8257
+#endif
+#ifndef GL_PROGRAM_BINARY_LENGTH
+#define GL_PROGRAM_BINARY_LENGTH 0x8741
+#endif
+#ifndef GL_NUM_PROGRAM_BINARY_FORMATS
+#define GL_NUM_PROGRAM_BINARY_FORMATS 0x87FE
+#endif
+
+namespace{
+    typedef void (APIENTRYP getProgramBinary_t)(GLuint program, GLsizei bufSize, 
+    GLsizei *length, GLenum *binaryFormat, void *binary);
+    typedef void (APIENTRYP programBinary_t)(GLuint program, GLenum binaryFormat, 
+    const void *binary, GLsizei length);
+    typedef void (APIENTRYP programParameteri_t)(GLuint program, GLenum pname, GLint value);
+
+    getProgramBinary_t getProgramBinary = NULL;
+    programBinary_t programBinary = NULL;
+    programParameteri_t programParameteri = NULL;
+
+    /* true if the driver can hand out program binaries, checked once
     */
-    std::string vertexCode;
-    std::string fragmentCode;
-    std::ifstream vShaderFile;
-    std::ifstream fShaderFile;
+    bool programBinarySupported(void){
+        static int supported = -1;
+        if(supported == -1){
+            getProgramBinary = (getProgramBinary_t)glfwGetProcAddress("glGetProgramBinary");
+            programBinary = (programBinary_t)glfwGetProcAddress("glProgramBinary");
+            programParameteri = (programParameteri_t)glfwGetProcAddress("glProgramParameteri");
+            int numFormats = 0;
+            if(getProgramBinary != NULL && programBinary != NULL && programParameteri != NULL)
+                glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+            supported = numFormats > 0;
+        }
+        return supported == 1;
+    }
 
-    /* ensure ifstream objects can throw exceptions
+    /* names in the order of shaderUniform
     */
-    vShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    fShaderFile.exceptions (std::ifstream::failbit | std::ifstream::badbit);
-    try {
-        /* open shader files
-        */
-        vShaderFile.open(vertexPath);
-        fShaderFile.open(fragmentPath);
+    const char *uniformNames[NUM_UNIFORMS] = {
+        "cellStates", "stroke", "gridSize", "lodLevel", "texOrigin", "viewOrigin", "viewSize",
+        "palette", "lineColor"
+    };
 
-        std::stringstream vShaderStream, fShaderStream;
-        /* read file's buffer contents into streams
+    uint64_t hashString(uint64_t hash, const char *str){
+        /* FNV-1a
         */
-        vShaderStream << vShaderFile.rdbuf();
-        fShaderStream << fShaderFile.rdbuf();
+        for(; str != NULL && *str != 0; str++){
+            hash ^= (unsigned char)*str;
+            hash *= 1099511628211ull;
+        }
+        return hash;
+    }
+}
 
-        /* close file handlers
-        */
-        vShaderFile.close();
-        fShaderFile.close();
+ShaderClass::ShaderClass(shaderType type){
+    const char* vShaderCode = type == LINE_SHADER ? lineVertexSource : gridVertexSource;
+    const char* fShaderCode = type == LINE_SHADER ? lineFragmentSource : gridFragmentSource;
 
-        /* convert stream into string
-        */
-        vertexCode   = vShaderStream.str();
-        fragmentCode = fShaderStream.str();
+    /* a cached binary skips compiling and linking, which is most
+     * of the start up time of the window
+    */
+    fromCache = false;
+    std::string cachePath;
+    if(programBinarySupported())
+        cachePath = getCachePath(vShaderCode, fShaderCode);
+    if(!cachePath.empty())
+        fromCache = loadProgramBinary(cachePath);
+    if(!fromCache){
+        compileProgram(vShaderCode, fShaderCode);
+        if(!cachePath.empty())
+            saveProgramBinary(cachePath);
     }
-    catch (std::ifstream::failure& e){
-        std::cout << "[ERROR] Shader file not successfully read" << std::endl;
+    loadUniformLocations();
+}
+
+std::string ShaderClass::getCachePath(const char *vShaderCode, const char *fShaderCode){
+    uint64_t hash = 14695981039346656037ull;
+    hash = hashString(hash, (const char*)glGetString(GL_VENDOR));
+    hash = hashString(hash, (const char*)glGetString(GL_RENDERER));
+    hash = hashString(hash, (const char*)glGetString(GL_VERSION));
+    hash = hashString(hash, vShaderCode);
+    hash = hashString(hash, fShaderCode);
+
+    /* empty if there is no cache directory, then the program is
+     * always compiled
+    */
+    std::filesystem::path dir;
+    const char *cacheHome = getenv("XDG_CACHE_HOME");
+    const char *home = getenv("HOME");
+    if(cacheHome != NULL && cacheHome[0] == '/')
+        dir = std::filesystem::path(cacheHome) / "RandomTree";
+    else if(home != NULL && home[0] == '/')
+        dir = std::filesystem::path(home) / ".cache" / "RandomTree";
+    else
+        return "";
+
+    std::error_code error;
+    std::filesystem::create_directories(dir, error);
+    if(!error)
+        std::filesystem::permissions(dir, std::filesystem::perms::owner_all,
+        std::filesystem::perm_options::replace, error);
+    if(error){
+        std::cout<<"[ERROR] Could not create shader cache directory "<<dir.string()<<": "
+                 <<error.message()<<std::endl;
+        return "";
+    }
+
+    std::stringstream name;
+    name<<"Shader_"<<std::hex<<hash<<".bin";
+    return (dir / name.str()).string();
+}
+
+/* the file holds the binary format followed by the binary
+*/
+bool ShaderClass::loadProgramBinary(const std::string& cachePath){
+    std::ifstream file(cachePath, std::ios::binary);
+    if(!file)
+        return false;
+    GLenum format;
+    file.read((char*)&format, sizeof(format));
+    if(!file)
+        return false;
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), 
+                             std::istreambuf_iterator<char>());
+    if(binary.empty())
+        return false;
+
+    ID = glCreateProgram();
+    programBinary(ID, format, binary.data(), binary.size());
+    /* the driver rejects binaries it can no longer use, then the
+     * program is compiled from source and the cache rewritten
+    */
+    int success;
+    glGetProgramiv(ID, GL_LINK_STATUS, &success);
+    if(!success){
+        glDeleteProgram(ID);
+        return false;
     }
-    /* Returns a pointer to an array that contains a 
-     * null-terminated sequence of characters (i.e., a 
-     * C-string) representing the current value of the 
-     * string object.
+    return true;
+}
+
+void ShaderClass::saveProgramBinary(const std::string& cachePath){
+    int length = 0;
+    glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH, &length);
+    if(length <= 0)
+        return;
+    std::vector<char> binary(length);
+    GLenum format;
+    getProgramBinary(ID, length, &length, &format, binary.data());
+
+    /* written to a file of its own and renamed over the cache file,
+     * so another window starting at the same time never reads half a
+     * binary
     */
-    const char* vShaderCode = vertexCode.c_str();
-    const char * fShaderCode = fragmentCode.c_str();
+    std::stringstream tmpPath;
+    tmpPath<<cachePath<<"."<<std::hex<<std::random_device()()<<".tmp";
+    {
+        std::ofstream file(tmpPath.str(), std::ios::binary);
+        if(file){
+            file.write((const char*)&format, sizeof(format));
+            file.write(binary.data(), length);
+        }
+        if(!file){
+            std::cout<<"[ERROR] Could not write shader cache "<<tmpPath.str()<<std::endl;
+            std::error_code error;
+            std::filesystem::remove(tmpPath.str(), error);
+            return;
+        }
+    }
+    std::error_code error;
+    std::filesystem::rename(tmpPath.str(), cachePath, error);
+    if(error){
+        std::cout<<"[ERROR] Could not write shader cache "<<cachePath<<": "<<error.message()
+                 <<std::endl;
+        std::filesystem::remove(tmpPath.str(), error);
+    }
+}
 
+void ShaderClass::compileProgram(const char *vShaderCode, const char *fShaderCode){
     /* In order for OpenGL to use the shader it has to 
      * dynamically compile it at run-time from its 
      * source code.
@@ -111,6 +255,10 @@ ShaderClass::ShaderClass(void){
      * object. 
     */
     ID = glCreateProgram();
+    /* ask the driver to keep the binary so it can be cached
+    */
+    if(programParameteri != NULL)
+        programParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
     /* Now we need to attach the previously compiled shaders 
      * to the program object and then link them with 
      * glLinkProgram
@@ -127,6 +275,16 @@ ShaderClass::ShaderClass(void){
     glDeleteShader(fragment);
 }
 
+/* Every uniform is looked up once here, the setters below only index
+ * the table and never call into the driver to find a location. The
+ * location is -1 for uniforms the program does not have (or the
+ * compiler removed), glUniform ignores location -1
+*/
+void ShaderClass::loadUniformLocations(void){
+    for(int k = 0; k < NUM_UNIFORMS; k++)
+        uniformLocations[k] = glGetUniformLocation(ID, uniformNames[k]);
+}
+
 void ShaderClass::use(){ 
     /* The result after linking is a program object that 
      * we can activate by calling glUseProgram with the 
@@ -140,26 +298,41 @@ void ShaderClass::use(){
 /* we query for the location of the uniform using 
  * glGetUniformLocation. We supply the shader program and 
  * the name of the uniform (that we want to retrieve the 
- * location from) to the query function. 
+ * location from) to the query function. The locations are
+ * queried once after linking and kept in a table.
  * 
  * If glGetUniformLocation returns -1, it could not find the 
  * location. Lastly we can set the uniform value using the 
  * glUniform_ function. 
 */
-void ShaderClass::setBool(const std::string &name, bool value) const{         
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value); 
+void ShaderClass::setBool(shaderUniform uniform, bool value) const{         
+    glUniform1i(uniformLocations[uniform], (int)value); 
+}
+
+void ShaderClass::setInt(shaderUniform uniform, int value) const{ 
+    glUniform1i(uniformLocations[uniform], value); 
 }
 
-void ShaderClass::setInt(const std::string &name, int value) const{ 
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value); 
+void ShaderClass::setFloat(shaderUniform uniform, float value) const{ 
+    glUniform1f(uniformLocations[uniform], value); 
 }
 
-void ShaderClass::setFloat(const std::string &name, float value) const{ 
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value); 
+void ShaderClass::setVec2(shaderUniform uniform, float x, float y) const{ 
+    glUniform2f(uniformLocations[uniform], x, y);
 }
 
-void ShaderClass::setVec4(const std::string &name, float x, float y, float z, float w) const{ 
-    glUniform4f(glGetUniformLocation(ID, name.c_str()), x, y, z, w); 
+void ShaderClass::setIVec2(shaderUniform uniform, int x, int y) const{ 
+    glUniform2i(uniformLocations[uniform], x, y);
+}
+
+void ShaderClass::setVec4(shaderUniform uniform, float x, float y, float z, float w) const{ 
+    glUniform4f(uniformLocations[uniform], x, y, z, w);
+}
+
+/* value holds count RGBA entries back to back
+*/
+void ShaderClass::setVec4Array(shaderUniform uniform, int count, const float *value) const{ 
+    glUniform4fv(uniformLocations[uniform], count, value); 
 }
 
 void ShaderClass::checkCompileErrors(unsigned int shader, std::string type){
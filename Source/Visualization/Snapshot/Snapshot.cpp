@@ -0,0 +1,349 @@
+#include "../../../Include/Visualization/Snapshot/Snapshot.h"
+#include <iostream>
+#include <fstream>
+#include <thread>
+#include <algorithm>
+#include <cstring>
+#include <cmath>
+
+SnapshotClass::SnapshotClass(int _N, int _cellSize, const std::vector<rgba_t>& _palette,
+int _numThreads){
+    N = _N;
+    cellSize = _cellSize;
+    imageDim = N * cellSize;
+    /* fall back to a single thread if the number of cores cannot be
+     * detected
+    */
+    numThreads = _numThreads > 0 ? _numThreads : std::max(1u, std::thread::hardware_concurrency());
+
+    for(int k = 0; k < _palette.size(); k++)
+        palette.push_back(packColor(_palette[k]));
+    if(palette.size() == 0)
+        palette.push_back(0xffffffff);
+
+    edgeColor = {0, 0, 255, 255};
+    pathColor = {255, 0, 0, 255};
+    pathWidth = 0;
+
+    image.resize((size_t)imageDim * imageDim);
+    if(cellSize > 1)
+        cellImage.resize((size_t)N * N);
+}
+
+/* the bytes are R,G,B,A in memory whatever the byte order is
+*/
+uint32_t SnapshotClass::packColor(rgba_t color){
+    uint32_t packed;
+    memcpy(&packed, &color, sizeof(packed));
+    return packed;
+}
+
+void SnapshotClass::setLineStyle(rgba_t _edgeColor, rgba_t _pathColor, int _pathWidth){
+    edgeColor = _edgeColor;
+    pathColor = _pathColor;
+    pathWidth = _pathWidth;
+}
+
+int SnapshotClass::getImageDim(void){
+    return imageDim;
+}
+
+const unsigned char* SnapshotClass::getPixels(void){
+    return (const unsigned char*)image.data();
+}
+
+/* color cell rows [jStart, jEnd) into out at one pixel per cell, row
+ * j of the cells is image row N-1-j
+*/
+void SnapshotClass::fillCells(const int *cells, uint32_t *out, int jStart, int jEnd){
+    uint32_t numColors = palette.size();
+    for(int j = jStart; j < jEnd; j++){
+        const int *row = cells + (size_t)j * N;
+        uint32_t *dst = out + (size_t)(N - 1 - j) * N;
+        for(int i = 0; i < N; i++){
+            uint32_t state = row[i];
+            dst[i] = palette[state < numColors ? state : 0];
+        }
+    }
+}
+
+/* scale the cell image up to pixel rows [yStart, yEnd), the first
+ * row of a cell is filled and the others are copies of it
+*/
+void SnapshotClass::scaleRows(int yStart, int yEnd){
+    for(int y = yStart; y < yEnd; y++){
+        uint32_t *row = &image[(size_t)y * imageDim];
+        if(y % cellSize != 0 && y != yStart){
+            memcpy(row, row - imageDim, imageDim * sizeof(uint32_t));
+            continue;
+        }
+        const uint32_t *src = &cellImage[(size_t)(y / cellSize) * N];
+        for(int j = 0; j < N; j++)
+            std::fill_n(row + j * cellSize, cellSize, src[j]);
+    }
+}
+
+/* center of a cell in pixels, y down from the top
+*/
+void SnapshotClass::getCellCenter(std::pair<int, int> cell, float& x, float& y){
+    x = (cell.first + 0.5) * cellSize;
+    y = (N - cell.second - 0.5) * cellSize;
+}
+
+void SnapshotClass::blendPixel(int x, int y, rgba_t color){
+    if(x < 0 || x >= imageDim || y < 0 || y >= imageDim)
+        return;
+    unsigned char *dst = (unsigned char*)&image[(size_t)y * imageDim + x];
+    int a = color.A;
+    dst[0] = (color.R * a + dst[0] * (255 - a) + 127)/255;
+    dst[1] = (color.G * a + dst[1] * (255 - a) + 127)/255;
+    dst[2] = (color.B * a + dst[2] * (255 - a) + 127)/255;
+}
+
+/* one pixel wide line between cell centers, every pixel along the
+ * longer axis is blended once
+*/
+void SnapshotClass::drawLine(std::pair<int, int> from, std::pair<int, int> to, rgba_t color){
+    float x1, y1, x2, y2;
+    getCellCenter(from, x1, y1);
+    getCellCenter(to, x2, y2);
+    int steps = std::max(fabs(x2 - x1), fabs(y2 - y1));
+    for(int k = 0; k <= steps; k++){
+        float t = steps == 0 ? 0 : (float)k/steps;
+        blendPixel((int)floor(x1 + t * (x2 - x1)), (int)floor(y1 + t * (y2 - y1)), color);
+    }
+}
+
+/* the path segment is a rectangle pathWidth + 0.5 cells on either
+ * side of the line between the cell centers, like in the window
+*/
+void SnapshotClass::drawThickLine(std::pair<int, int> from, std::pair<int, int> to,
+rgba_t color){
+    float x1, y1, x2, y2;
+    getCellCenter(from, x1, y1);
+    getCellCenter(to, x2, y2);
+    float dx = x2 - x1;
+    float dy = y2 - y1;
+    float len = sqrt(dx * dx + dy * dy);
+    if(len == 0)
+        return;
+    dx /= len;
+    dy /= len;
+    float halfWidth = (pathWidth + 0.5) * cellSize;
+
+    int xMin = std::max((int)floor(std::min(x1, x2) - halfWidth), 0);
+    int xMax = std::min((int)ceil(std::max(x1, x2) + halfWidth), imageDim - 1);
+    int yMin = std::max((int)floor(std::min(y1, y2) - halfWidth), 0);
+    int yMax = std::min((int)ceil(std::max(y1, y2) + halfWidth), imageDim - 1);
+    for(int y = yMin; y <= yMax; y++){
+        for(int x = xMin; x <= xMax; x++){
+            /* pixel center along and across the segment
+            */
+            float px = x + 0.5 - x1;
+            float py = y + 0.5 - y1;
+            float along = px * dx + py * dy;
+            float across = px * dy - py * dx;
+            if(along >= 0 && along <= len && fabs(across) <= halfWidth)
+                blendPixel(x, y, color);
+        }
+    }
+}
+
+void SnapshotClass::render(const int *cells, const std::vector<snapshotLine_t>& edges,
+const std::vector<std::pair<int, int>>& path){
+    /* cell colors, split into bands of cell rows over the threads
+    */
+    uint32_t *out = cellSize == 1 ? image.data() : cellImage.data();
+    int band = (N + numThreads - 1)/numThreads;
+    std::vector<std::thread> workers;
+    for(int t = 1; t < numThreads && t * band < N; t++)
+        workers.push_back(std::thread(&SnapshotClass::fillCells, this, cells, out, t * band,
+        std::min((t + 1) * band, N)));
+    fillCells(cells, out, 0, std::min(band, N));
+    for(int t = 0; t < workers.size(); t++)
+        workers[t].join();
+    workers.clear();
+
+    if(cellSize > 1){
+        int rows = ((N + numThreads - 1)/numThreads) * cellSize;
+        for(int t = 1; t < numThreads && t * rows < imageDim; t++)
+            workers.push_back(std::thread(&SnapshotClass::scaleRows, this, t * rows,
+            std::min((t + 1) * rows, imageDim)));
+        scaleRows(0, std::min(rows, imageDim));
+        for(int t = 0; t < workers.size(); t++)
+            workers[t].join();
+    }
+
+    /* line overlay, the cost depends on the number of edges
+    */
+    for(int k = 0; k < edges.size(); k++)
+        drawLine(edges[k].first, edges[k].second, edgeColor);
+    for(int k = 1; k < path.size(); k++)
+        drawThickLine(path[k - 1], path[k], pathColor);
+}
+
+/* binary PPM, the alpha channel is dropped
+*/
+bool SnapshotClass::writePPM(const std::string& fileName){
+    std::ofstream file(fileName, std::ios::binary);
+    if(!file){
+        std::cout<<"[ERROR] Could not open "<<fileName<<std::endl;
+        return false;
+    }
+    file<<"P6\n"<<imageDim<<" "<<imageDim<<"\n255\n";
+    std::vector<unsigned char> row(imageDim * 3);
+    const unsigned char *pixels = getPixels();
+    for(int y = 0; y < imageDim; y++){
+        const unsigned char *src = pixels + (size_t)y * imageDim * 4;
+        for(int x = 0; x < imageDim; x++){
+            row[3 * x] = src[4 * x];
+            row[3 * x + 1] = src[4 * x + 1];
+            row[3 * x + 2] = src[4 * x + 2];
+        }
+        file.write((const char*)row.data(), row.size());
+    }
+    return file.good();
+}
+
+/* PNG writer with no dependencies, the image data is stored in
+ * uncompressed deflate blocks. The chunks are checked with CRC32 and
+ * the zlib stream with Adler32
+*/
+namespace{
+    /* built at compile time, so the writers of several threads never
+     * race to fill it
+    */
+    struct crcTable_t{
+        uint32_t values[256];
+
+        constexpr crcTable_t(void) : values{}{
+            for(uint32_t n = 0; n < 256; n++){
+                uint32_t c = n;
+                for(int k = 0; k < 8; k++)
+                    c = c & 1 ? 0xedb88320u ^ (c >> 1) : c >> 1;
+                values[n] = c;
+            }
+        }
+    };
+    constexpr crcTable_t crcTable;
+
+    uint32_t updateCrc(uint32_t crc, const unsigned char *data, size_t size){
+        for(size_t k = 0; k < size; k++)
+            crc = crcTable.values[(crc ^ data[k]) & 0xff] ^ (crc >> 8);
+        return crc;
+    }
+
+    void putBigEndian(unsigned char *out, uint32_t value){
+        out[0] = value >> 24;
+        out[1] = value >> 16;
+        out[2] = value >> 8;
+        out[3] = value;
+    }
+
+    /* writes the bytes of one chunk and keeps its CRC
+    */
+    struct chunkWriter_t{
+        std::ofstream *file;
+        uint32_t crc;
+
+        void begin(const char *type, uint32_t length){
+            unsigned char header[8];
+            putBigEndian(header, length);
+            memcpy(header + 4, type, 4);
+            file->write((const char*)header, 8);
+            crc = updateCrc(0xffffffffu, header + 4, 4);
+        }
+        void write(const unsigned char *data, size_t size){
+            file->write((const char*)data, size);
+            crc = updateCrc(crc, data, size);
+        }
+        void end(void){
+            unsigned char out[4];
+            putBigEndian(out, crc ^ 0xffffffffu);
+            file->write((const char*)out, 4);
+        }
+    };
+}
+
+bool SnapshotClass::writePNG(const std::string& fileName){
+    std::ofstream file(fileName, std::ios::binary);
+    if(!file){
+        std::cout<<"[ERROR] Could not open "<<fileName<<std::endl;
+        return false;
+    }
+    const unsigned char signature[8] = {137, 80, 78, 71, 13, 10, 26, 10};
+    file.write((const char*)signature, 8);
+
+    chunkWriter_t chunk = {&file, 0};
+    /* 8 bits per channel RGBA, no interlacing
+    */
+    unsigned char ihdr[13];
+    putBigEndian(ihdr, imageDim);
+    putBigEndian(ihdr + 4, imageDim);
+    ihdr[8] = 8;    ihdr[9] = 6;    ihdr[10] = 0;   ihdr[11] = 0;   ihdr[12] = 0;
+    chunk.begin("IHDR", 13);
+    chunk.write(ihdr, 13);
+    chunk.end();
+
+    /* every row is a filter byte (0, none) followed by the pixels,
+     * cut into stored blocks of at most 65535 bytes
+    */
+    const size_t maxBlock = 65535;
+    size_t rowBytes = (size_t)imageDim * 4 + 1;
+    size_t rawBytes = rowBytes * imageDim;
+    size_t numBlocks = std::max((rawBytes + maxBlock - 1)/maxBlock, (size_t)1);
+    size_t idatBytes = 2 + numBlocks * 5 + rawBytes + 4;
+    if(idatBytes > 0x7fffffffu){
+        std::cout<<"[ERROR] Snapshot too large for a single PNG chunk"<<std::endl;
+        return false;
+    }
+
+    chunk.begin("IDAT", idatBytes);
+    const unsigned char zlibHeader[2] = {0x78, 0x01};
+    chunk.write(zlibHeader, 2);
+
+    uint32_t adlerA = 1, adlerB = 0;
+    size_t blockLeft = 0, written = 0;
+    const unsigned char *pixels = getPixels();
+    const unsigned char filter = 0;
+    for(int y = 0; y < imageDim; y++){
+        const unsigned char *row = pixels + (size_t)y * imageDim * 4;
+        /* the row is written as the filter byte and the pixels, with
+         * a block header wherever a block starts
+        */
+        size_t rowPos = 0;
+        while(rowPos < rowBytes){
+            if(blockLeft == 0){
+                size_t blockSize = std::min(maxBlock, rawBytes - written);
+                unsigned char header[5];
+                header[0] = written + blockSize == rawBytes ? 1 : 0;
+                header[1] = blockSize & 0xff;
+                header[2] = blockSize >> 8;
+                header[3] = ~blockSize & 0xff;
+                header[4] = (~blockSize >> 8) & 0xff;
+                chunk.write(header, 5);
+                blockLeft = blockSize;
+            }
+            size_t n = std::min(blockLeft, rowBytes - rowPos);
+            const unsigned char *data = rowPos == 0 ? &filter : row + rowPos - 1;
+            if(rowPos == 0)
+                n = 1;
+            chunk.write(data, n);
+            for(size_t k = 0; k < n; k++){
+                adlerA = (adlerA + data[k]) % 65521;
+                adlerB = (adlerB + adlerA) % 65521;
+            }
+            rowPos += n;
+            blockLeft -= n;
+            written += n;
+        }
+    }
+    unsigned char adler[4];
+    putBigEndian(adler, (adlerB << 16) | adlerA);
+    chunk.write(adler, 4);
+    chunk.end();
+
+    chunk.begin("IEND", 0);
+    chunk.end();
+    return file.good();
+}
@@ -1,8 +1,22 @@
 #include "../Include/Simulation/Constants.h"
 #include "../Include/Simulation/RandomTree.h"
+#include "../Include/Utils/Stats.h"
+#include "../Include/Utils/Trace.h"
 
 int main(void){
     RandomTreeClass RandomTree(step, neighborhood, N, scale, true);
-    RandomTree.runRender();
+#if CAPTURE_MODE == 1
+    RandomTree.startCapture(captureFilePrefix, CAPTURE_FORMAT);
+#endif
+#if TRACE_MODE == 1
+    traceStart();
+#endif
+    RandomTree.runRender(SIMULATION_THREAD == 1, frameBudget);
+#if STATS_ENABLED == 1
+    statsWriteJSON(statsFileName);
+#endif
+#if TRACE_ENABLED == 1
+    traceWriteJSON(traceFileName);
+#endif
     return 0;
 }
\ No newline at end of file